@@ -0,0 +1,50 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Photodiode light source: ADC reading, preamp gain via MCP4151 digipot
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "Arduino.h"
+#include "LarvaDefs.hpp"
+#include "LightSource.hpp"
+#include "MCP4151Controller.hpp"
+
+class AdcLightSource : public LightSource
+{
+public:
+    AdcLightSource(){}
+    virtual ~AdcLightSource(){}
+
+    virtual void Init(){
+        pinMode( cPhotoSensPin, INPUT );
+        mDigiPot.SetGain( mGain );
+        mDigiPot.Init();
+    }
+
+    virtual int Read(){
+        return analogRead( cPhotoSensPin );
+    }
+
+    // the pot is written on Flush()
+    virtual void SetGain( const int acGain ){
+        mGain = acGain;
+        mDigiPot.SetGain( acGain );
+    }
+
+    virtual void Flush(){
+        mDigiPot.Flush();
+    }
+
+private:
+    // Photodiode gain controller
+    MCP4151Controller mDigiPot;
+};
@@ -0,0 +1,144 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Wavetable drone engine (DRONE_WAVETABLE, see LarvaString)
+//
+// the partials of a string are harmonics of its fundamental, so the
+// sum of TNumPartials sines is one periodic wave: it is stored as a
+// single cycle table and played by one oscillator.
+// The per-partial detune is approximated by cDroneWaveOscs tables
+// (partial i goes to table i % cDroneWaveOscs), each played at the
+// mean fundamental of its partials, so they beat slowly against each other.
+//
+// Tables are int32 sums of gain * sine cell, in the same units as
+// the additive engine (int8 sine x 8 bit gain). Gain changes are
+// added as deltas, only for the partials that changed: exact in
+// integers, no drift, no full rebuild @kr.
+// 256 cells + linear interpolation: same spur floor as the 2048 cells
+// non interpolated sine oscillators (~-46dB), rebuilds 8x cheaper.
+// No Arduino dependencies, see tools/DroneEngineBench.cpp
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const int cDroneWaveOscs = 2;
+static const int cDroneWaveTableBits = 8;
+static const int cDroneWaveFracBits = 10;
+static const int cDroneWaveTableSize = 1 << cDroneWaveTableBits;
+
+// source sine cycle, e.g. SIN2048_DATA
+static const int cDroneWaveSinSize = 2048;
+
+template <int TNumPartials>
+class DroneWavetable
+{
+public:
+    DroneWavetable(){}
+    ~DroneWavetable(){}
+
+    // callme @ setup
+    // apSin: one sine cycle, cDroneWaveSinSize int8 cells
+    void Init( const int8_t* apSin, const float acSampleRate ){
+        mpSin = apSin;
+        mIncScale = 4294967296.f / acSampleRate;
+        for ( int i = 0; i < TNumPartials; ++i ){
+            mHarmonic[i] = i + 1;
+            mApplied[i] = 0;
+        }
+        Clear();
+    }
+
+    // callme on retune: partial i is harmonic acFirstHarmonic + i,
+    // rebuilds the tables with the current gains
+    void SetHarmonics( const int acFirstHarmonic ){
+        Clear();
+        for ( int i = 0; i < TNumPartials; ++i ){
+            mHarmonic[i] = acFirstHarmonic + i;
+            if ( mApplied[i] != 0 ){
+                AddPartial( i, mApplied[i] );
+            }
+        }
+    }
+
+    // callme @kr, partial gains [0,255]
+    void SetGains( const uint8_t* apGains ){
+        for ( int i = 0; i < TNumPartials; ++i ){
+            int vdelta = (int)apGains[i] - mApplied[i];
+            if ( vdelta != 0 ){
+                AddPartial( i, vdelta );
+                mApplied[i] = apGains[i];
+            }
+        }
+    }
+
+    // callme when the partial freqs change (retune, lfo)
+    void SetFreqs( const float* apFreqs ){
+        for ( int k = 0; k < cDroneWaveOscs; ++k ){
+            float vfund = 0.f;
+            int vn = 0;
+            for ( int i = k; i < TNumPartials; i += cDroneWaveOscs ){
+                vfund += apFreqs[i] / (float)mHarmonic[i];
+                vn++;
+            }
+            mInc[k] = (uint32_t)( vfund / (float)vn * mIncScale );
+        }
+    }
+
+    // callme @sr
+    inline int32_t Next(){
+        int32_t vout = 0;
+        for ( int k = 0; k < cDroneWaveOscs; ++k ){
+            mPhase[k] += mInc[k];
+            // |cell delta| < 2^20, x 10 bit frac fits in 32 bits
+            const int32_t* vcell = mTable[k] + ( mPhase[k] >> ( 32 - cDroneWaveTableBits ) );
+            int32_t vfrac = ( mPhase[k] >> ( 32 - cDroneWaveTableBits - cDroneWaveFracBits ) ) 
+                            & ( ( 1 << cDroneWaveFracBits ) - 1 );
+            vout += vcell[0] + ( ( ( vcell[1] - vcell[0] ) * vfrac ) >> cDroneWaveFracBits );
+        }
+        return vout;
+    }
+
+private:
+
+    inline void Clear(){
+        for ( int k = 0; k < cDroneWaveOscs; ++k ){
+            for ( int j = 0; j <= cDroneWaveTableSize; ++j ){
+                mTable[k][j] = 0;
+            }
+        }
+    }
+
+    // table += acGain * sine at the partial's harmonic
+    void AddPartial( const int acPartial, const int acGain ){
+        int32_t* vtable = mTable[ acPartial % cDroneWaveOscs ];
+        const int vstep = mHarmonic[acPartial] * ( cDroneWaveSinSize / cDroneWaveTableSize );
+        int vidx = 0;
+        for ( int j = 0; j < cDroneWaveTableSize; ++j ){
+            vtable[j] += acGain * mpSin[vidx];
+            vidx = ( vidx + vstep ) & ( cDroneWaveSinSize - 1 );
+        }
+        vtable[cDroneWaveTableSize] = vtable[0];
+    }
+
+private:
+    const int8_t* mpSin{NULL};
+    float mIncScale{0.f};
+
+    int mHarmonic[TNumPartials];
+    int mApplied[TNumPartials];
+
+    // + guard cell = cell 0, for the interpolation
+    int32_t mTable[cDroneWaveOscs][cDroneWaveTableSize + 1];
+    uint32_t mPhase[cDroneWaveOscs] = {};
+    uint32_t mInc[cDroneWaveOscs] = {};
+};
@@ -0,0 +1,30 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Float environment for host builds
+//
+// subnormal floats trap to microcode on x86, so host renders and
+// benchmarks of decaying filters measure the traps, not the dsp.
+// FloatEnvFlushToZero() sets FTZ & DAZ on x86 (SSE), no-op elsewhere.
+// callme at the start of host tools, per thread.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+inline void FloatEnvFlushToZero(){
+#if defined(__SSE__) || defined(_M_X64)
+    // FTZ (bit 15) | DAZ (bit 6)
+    _mm_setcsr( _mm_getcsr() | 0x8040 );
+#endif
+}
@@ -0,0 +1,153 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Golden output hashes for the RENDER_CHECK build
+//
+// Two sets: the host one (RENDER_CHECK_HOST, tools/RenderCheckHost.cpp,
+// default LarvaDefs.hpp switches) and the board one. The board's libm
+// and its fused multiply-add round differently from the host, so the
+// host hashes do not carry over.
+// To (re)capture: run the render check, paste the printed tables in
+// the matching set and set the trace's captured flag. Traces without
+// captured values are rendered and printed but not compared.
+// Recapture only when a change is meant to alter the sound.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "RenderHash.hpp"
+#include "LarvaDefs.hpp"
+
+static const unsigned long cRenderCheckSeed = 20211;
+
+static const int cRenderCheckBlocks = 
+    cRenderTraceTicks * ( AUDIO_RATE / CONTROL_RATE ) / cRenderHashBlockSize;
+
+#ifdef RENDER_CHECK_HOST
+
+static const bool cGoldenCaptured[kNumRenderTraces] = { true, true, true };
+
+static const uint32_t cGoldenHashes[kNumRenderTraces][cRenderCheckBlocks] = {
+    // kTraceSweep
+    {
+        0x38699dc5,0x38699dc5,0x38699dc5,0x0d685e56,0x69a08565,0x1e85b55e,0xa1ff1168,0xa10afea5,
+        0xc8e05250,0xac4a19a0,0x8c75eda5,0x9036c41b,0x3c5cdfac,0x0c0996b9,0x8c73b833,0xa2ec7aae,
+        0xc069f9f9,0xd94d1953,0x6a6c4a5b,0xb32192df,0x89f0e6a2,0x76d96246,0x91ff29df,0x43e44db3,
+        0xe843c730,0x8f948edf,0xee474b27,0x15d36fd4,0xd1467ab0,0x01652f0f,0xe67c93bf,0xcc243db4,
+        0x6a384787,0x0a8638fa,0xedc8a3b7,0x8c040d42,0x8e28334c,0x7afe9420,0x285ee746,0x0ed0ce4a,
+        0x31bf060e,0x05fa6f12,0x97bf0a5b,0xea64cdb5,0x8308052a,0x7c6f386f,0x9143363e,0x07e3aa8b,
+        0xe07678ea,0xb1a6eb49,0x2d988e78,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x26bec3b0,0x52d6d1b4,0xcfaa5a3e,0x8379799a,0x4279ba08,
+        0xe1c90698,0x7e79b4a0,0xe6b6ce4e,0x7a5a38ff,0x8d34ca33,0xd2176f74,0x025529c6,0x9fbe528a,
+        0x41685ada,0xcce329a0,0x0a82dd04,0x6b6268ce,0xf07d33d5,0xb8d411d8,0x3ad1478c,0x4d0cee90,
+        0x865cc4eb,0x53a13c65,0x433acd82,0xebe2930e,0xeba505cf,0xed5ce4f5,0xa54d9b91,0xcc10082b,
+        0xf6d30dff,0x1a5f19ea,0x3e1e4c1f,0x557915de,0x10864775,0x41521609,0x4f68cfa4,0x061f1085,
+        0x477e9426,0x4cd0a09f,0xef4d1134,0xc90a03bb,0xa6874759,0x90e153cc,0x9740a1dc,0x42b36475,
+        0xffc84cff,0xfaec324b,0x6611ff41,0x16145d3a,0x3c2a9fd0,0x7779da43,0x0ce6abe4,0xeee105db,
+        0x6f45c873,0x77da268d,0xf96647f8,0x22c53e2c,0x9fa02d27,0x4efe9dbc,0x33729752,0x5f7e3d53,
+        0x5fa4bda4,0xaeeac5f2,0x1f0c1ca4,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+    },
+    // kTraceFlicker
+    {
+        0x38699dc5,0x38699dc5,0x74320927,0x38d58729,0x29f1c750,0xfcbe94e9,0x0ed7249f,0x03bdbfea,
+        0xa9fd5181,0xb00b59d7,0x5a90ba90,0x16ed415c,0x6fcb2a8d,0xaea292b3,0xeff30077,0xea8026ac,
+        0xdb6c32c5,0xcc2885f1,0x01c0a017,0x61cbd526,0x1080c962,0xde534931,0x7647c46d,0x0312f580,
+        0x5b7ab223,0x128c7a87,0x7771e43a,0x71278479,0x5282b728,0x3b283e50,0x2ee61f7e,0xe4e5b638,
+        0xd72797f1,0xc3b78e90,0x248d50b9,0x17f5d6fb,0x588f3e62,0x54ae9885,0xa9b98501,0x511fd79a,
+        0xe60c63e6,0xa9b4aaec,0x33bc42d0,0x658aa066,0x286e5076,0x693b6a5e,0x7439a80c,0x9913034b,
+        0xcd4ce0bc,0x97c476c7,0x46dbf1cf,0x4d4ffbf8,0x423f8d65,0x935665d5,0x6c9c3db8,0x7cad9a58,
+        0x4cf21603,0xf497830c,0xeebb6cd4,0x7390163c,0xd1b9b12f,0x9afe30e0,0xc2242f27,0x465563a3,
+        0x4b561151,0x6868e94d,0x5ba080c6,0x4f178689,0x0094a735,0xfc94b307,0xcd1ac42a,0x3b10ca3d,
+        0x57885290,0x3841f993,0x99c685a6,0x5733e4a2,0xaaddb17f,0x53752424,0x2d30e64a,0x012f5cc3,
+        0xe22de110,0x5a9b1b20,0xba4239d3,0x87da6e62,0xbdfee4af,0xea40e3d4,0xbead5c11,0x7b1460a7,
+        0x85ebfb79,0x24a99d32,0x24769cc8,0x6f67d4bf,0x17e04e80,0xcb36c78f,0x8b74613e,0x0861ee7c,
+        0xf131e2c6,0xe3bb2a06,0x14011dfa,0x6d8e865e,0x8b8aa6b7,0xefda0bcc,0x652c9c82,0x6f6605ca,
+        0x842e55c0,0xc0b59260,0x14e7be18,0x8fbef767,0xf13ef538,0xc48fd1d8,0xb1d31bae,0xabe10f7d,
+        0x529ce947,0x03195c4a,0x668142b3,0x9809fa2b,0xfc414632,0x7d36218d,0x282aebab,0xc2852d99,
+        0xec98a1ed,0xe955dafb,0x0fe90844,0x065979bc,0x125049ab,0x5904aa1c,0xbb58b3c8,0x80168366,
+        0xeff91ab2,0x8c9ec977,0xbdc3eac1,0xbc7abbec,0xa5a3fb4e,0xf55f74cb,0x9d9c785e,0x53404c10,
+        0x4b9eea1a,0xcbf67c34,0xa4adcc58,0xc59a29a3,0x8aed537e,0x33dc6d9a,0x25203ae0,0xf13d9469,
+        0xe0240b67,0xdba2ed3d,0x16d8e157,0x169a18c6,0x8587ae81,0x0171691c,0xfa642a1f,0x360adb49,
+        0xa8513fea,0x3e5973af,0x6e8f9011,0x4553b922,0xda7d52ed,0x8a541cd9,0x0443cf56,0xdbe2610f,
+        0x4157f8c6,0x1bb20359,0x563cca6d,0x9026b297,0x833fb8d2,0x127fbe56,0x7111070d,0xfefa8511,
+        0x8d8df4af,0x99a70569,0x1d0613b7,0xfd5323b3,0xf6fcdf0e,0xe8516b22,0x9a3dbbbd,0x060b4a59,
+        0x17b57b0e,0xf805fbd9,0xc86a6254,0x8d85819a,0x3e139ef0,0x9f45a009,0x0d76587d,0xfbcf2df3,
+        0x72e5f7b9,0x4b23edbb,0xd29e151f,0xbabde44a,0xf4e11e1e,0xefdc33fe,0x9242be20,0x311ff98d,
+        0x08eee7c8,0x79a8ae37,0xd34d308e,0x113cf714,0x7f16406f,0xed6388ef,0x7797d92b,0xde069686,
+        0xa434dea5,0xfd9a2166,0x3d1150a9,0xd9eb5c2c,0x31f620a9,0x5253b034,0xc8acec2a,0x056ce8a2,
+        0x80e57ace,0x21574bfa,0x3caf5ad5,0x49ddf7f1,0xa581ee09,0x9762fff0,0x1ae8a6e3,0x8bcaa90f,
+        0xc9b74f81,0x847a6d4b,0x77e46ff4,0xcb4c1329,0x15c876a9,0x1ce05063,0x8af3e949,0xa555add5,
+        0x61865734,0xab8abce4,0x1f72b56f,0x4937f2c0,0x693f317e,0xad35f792,0x4d515d13,0x3c66c174,
+        0x131cda1a,0xd094af5e,0x2129db53,0xb86808cd,0x410cdb42,0x34fb3ce3,0x6549e1e6,0x50cbb47b,
+    },
+    // kTraceSteps
+    {
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x47e93cba,0x18b164d0,0x9e8e3f12,0x5021d447,0x2a7cdab7,0x3fb2be31,0x02e65cc9,0x2e0c4939,
+        0x13a6c86e,0x9e0e9d4e,0x171e367f,0x8c2e43d0,0x0842b003,0x47d7f47c,0x6cf08e1c,0xb578306e,
+        0x20b76e7c,0xd43cc1f5,0xe1b356af,0x8b7d62ef,0x473f72ce,0x65b2260f,0xccb87519,0x02feb966,
+        0x59ad2446,0x0eef6ed4,0x056dc81f,0x3d75802e,0x2b7c8eb1,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0xe3544b71,0x73a08215,0x8d1cdf6c,0x4cce0775,0xb9920337,0x4df08da9,0x1e550dc5,0x8700eb14,
+        0x2a0bbf92,0xb14d39e6,0xb09a6d99,0x83e89081,0x214e6da5,0xcf2b3226,0xc00f0227,0x7fcc6348,
+        0xe0e85e51,0xce23e122,0x54f26ade,0x9f527d2b,0xdf078c1b,0x113b1903,0x7c6868df,0x0fa713bb,
+        0xb0ab5872,0x72607903,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0xfa5ec9d8,0x3bb6d035,0x921fa629,0xb2175572,0xab4cfbc5,0x2d00bc5a,0x6fffde8d,0xc50b7cd5,
+        0x16664fed,0x0223dc6d,0xa5288a2d,0xceeff489,0x169f2d4e,0x6b64f4f1,0xbceb5145,0xad9368c4,
+        0x0edec76a,0xb0d22e9f,0x7d39625e,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x986d1b6b,0x4d627552,0x019d45b8,0x79f048c1,0x7017bf51,0x85514ff5,0xca3925bc,0xa9f4d052,
+        0x62db5c75,0x3ea2018d,0x474a335b,0xd5b8a9fb,0xb5a25c5b,0xa40b17d6,0x877899dd,0x971ac630,
+        0x5b17c72b,0xa39c556c,0x3722805f,0x67221726,0x671b4b56,0xdb411b6a,0x1566065a,0x96e16a92,
+        0x1da80291,0x581a699a,0x5c21b42f,0xb5e6ac62,0x85647ecf,0x319d03d0,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+        0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,0x38699dc5,
+    },
+};
+
+#else
+
+// not captured on the board yet
+static const bool cGoldenCaptured[kNumRenderTraces] = { false, false, false };
+
+static const uint32_t cGoldenHashes[kNumRenderTraces][cRenderCheckBlocks] = {
+    // kTraceSweep
+    { 0 },
+    // kTraceFlicker
+    { 0 },
+    // kTraceSteps
+    { 0 },
+};
+
+#endif
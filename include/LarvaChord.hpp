@@ -15,6 +15,8 @@
 
 #include "LarvaDefs.hpp"
 #include "LarvaString.hpp"
+#include "RandStream.hpp"
+#include "Profiler.hpp"
 
 class LarvaChord
 {
@@ -25,7 +27,7 @@ public:
 
     void Init( const ChordID acChord );
     
-    // callme @sr
+    // callme @sr, in output units (see cMixOutScale)
     float Process() 
     {
         float vMix = 0.f;
@@ -33,8 +35,14 @@ public:
             vMix += mpActiveStrings[s]->Process();
         }
 
-        // scale by number of strings
-        vMix *= 0.33f;
+        // scale by number of strings, to output units
+        vMix *= cChordMixGain;
+
+        // linear fade to 0, then Update() resets the chord
+        if ( mReleasing ){
+            vMix *= mReleaseGain;
+            mReleaseGain = mReleaseGain > cReleaseStep ? mReleaseGain - cReleaseStep : 0.f;
+        }
 
         return vMix; 
     }
@@ -46,15 +54,15 @@ public:
         if (mActive==true){
             //Serial.print("- Muting Chord "); Serial.println(mID);
             mActive=false; 
+            PickNextVoicing();
         }
     }
     
     inline void Unmute(){ 
         if (mActive==false){
             
-            // each time the audio output is zero (completely silent), the 3 strings are retuned.
-            Retune();
-
+            // each time the audio output is zero (completely silent), the 3 strings are retuned:
+            // the voicing is picked at mute, the strings swap their pre-rolled tuning in on unmute
             mActive=true; 
             mTriggered=true;
             //Serial.print("- Unmuting Chord "); Serial.println(mID);
@@ -63,9 +71,65 @@ public:
 
     inline bool Active(){ return mActive; }
     inline bool Triggered(){ return mTriggered; }
+
+    // polyphony cap: fade out and reset, light input is ignored meanwhile
+    inline void Release(){
+        if ( mActive && !mReleasing ){
+            mReleasing = true;
+            mReleaseGain = 1.f;
+        }
+    }
+
+    inline bool Releasing(){ return mReleasing; }
+
+    // silence now, all strings back to idle
+    void Reset();
+
+    inline bool InRange( const int acLight ){
+        return acLight >= mLightRangeMin && acLight < mLightRangeMax;
+    }
+
+    // sum of the smoothed partial gains
+    inline int Energy(){
+        int ve = 0;
+        for ( int s = 0; s < mNumActiveStrings; ++s ){
+            ve += mpActiveStrings[s]->Energy();
+        }
+        return ve;
+    }
+
+    inline int NumActiveStrings(){ return mNumActiveStrings; }
+
+    inline int NumActivePartials(){
+        int vn = 0;
+        for ( int s = 0; s < mNumActiveStrings; ++s ){
+            vn += mpActiveStrings[s]->NumActivePartials();
+        }
+        return vn;
+    }
+
+    inline int NumActivePloks(){
+        int vn = 0;
+        for ( int s = 0; s < mNumActiveStrings; ++s ){
+            vn += mpActiveStrings[s]->NumActivePloks();
+        }
+        return vn;
+    }
     
+    // immediate retune of all strings
     void Retune();
 
+    // callme @kr, pre-rolls the tuning of at most one muted string
+    // true if there was work to do
+    inline bool PrerollRetune(){
+        for (int s = 0; s < cNumStrings; ++s){
+            if ( mString[s].PrerollRetune() ){
+                return true;
+            }
+        }
+        return false;
+    }
+
     void SetLightRange(const int acMin, const int acMax);
     
     inline void SetPulseMasterGain(const float acValue){
@@ -79,19 +143,36 @@ public:
             mpActiveStrings[s]->SetPulseResonanceAvg(acValue);
         }
     }
+    // all strings, muted ones pick it up when they start
+    inline void SetShedLevel(const int acLevel){
+        for (int s = 0; s < cNumStrings; ++s){
+            mString[s].SetShedLevel(acLevel);
+        }
+    }
+
     inline ChordID ID(){ return mID; }
 
 private:
     bool mActive{false};
     bool mTriggered{false};
 
+    static constexpr float cChordMixGain = 0.33f * cMixOutScale;
+    static constexpr float cReleaseStep = 1.f / ( cChordReleaseTicks * ( AUDIO_RATE / CONTROL_RATE ) );
+    bool mReleasing{false};
+    float mReleaseGain{1.f};
+
     int mLightRangeMin{0};
     int mLightRangeMax{0};
 
     ChordID mID{kChord1};
+
+    void PickNextVoicing();
+
+    // voicing choice
+    RandStream mRand;
     
     int mNumActiveStrings{0};
-    LarvaString* mpActiveStrings[cNumStrings];
+    LarvaString* mpActiveStrings[cNumStrings]{};
     LarvaString mString[cNumStrings];
 };
 
@@ -15,7 +15,83 @@
 
 #include "MozziGuts.h"
 
-//#define PRINT
+// section timing, see Profiler.hpp
+//#define PROFILE
+
+// binary telemetry stream on Serial, see Telemetry.hpp
+//#define TELEMETRY
+
+#if defined(TELEMETRY) && defined(PROFILE)
+#error TELEMETRY shares Serial with PROFILE text output, enable only one
+#endif
+
+// drop the quietest partials & plok voices when the render approaches its deadline, 
+// see LoadGovernor.hpp
+#define LOAD_GOVERNOR
+
+// record the sensor input to flash, see LightTraceRecorder.hpp
+//#define LIGHT_TRACE
+
+// dump the recorded trace to Serial at startup (no recording in this mode)
+//#define LIGHT_TRACE_DUMP
+
+// photodiode sampled in the background and decimated, 
+// comment out for one blocking read per control tick
+#define SENSOR_OVERSAMPLE
+
+// replace the photodiode input (see LightSource.hpp):
+// LIGHT_REPLAY plays the recorded trace back, LIGHT_SYNTH generates dense flicker for load tests
+//#define LIGHT_REPLAY
+//#define LIGHT_SYNTH
+
+#if defined(LIGHT_REPLAY) && defined(LIGHT_TRACE)
+#error LIGHT_TRACE would overwrite the trace LIGHT_REPLAY is reading, enable only one
+#endif
+
+// lux scaling with the float reference instead of the lookup tables (LuxScaler.hpp)
+//#define LUX_SCALE_FLOAT
+
+// integer plok resonators instead of float, see PlokResonator.hpp
+//#define PLOK_FIXED
+
+// partials below cDroneSubRateCutoff rendered at AUDIO_RATE / cDroneSubRate, see LarvaString::Process
+//#define DRONE_MULTIRATE
+
+// drone engine: one wavetable per partial group instead of one oscillator per partial, 
+// see DroneWavetable.hpp
+//#define DRONE_WAVETABLE
+
+// drone engine: table-free recursive sine oscillators instead of Oscil, 
+// see RecursiveSineBank.hpp
+//#define DRONE_RECURSIVE
+
+#if defined(DRONE_WAVETABLE) && defined(DRONE_RECURSIVE)
+#error enable only one drone engine
+#endif
+
+#if ( defined(DRONE_WAVETABLE) || defined(DRONE_RECURSIVE) ) && defined(DRONE_MULTIRATE)
+#error DRONE_MULTIRATE applies to the additive engine only
+#endif
+
+// piecewise linear knee on the output above cMixKnee (a hard corner, slope 1/4)
+// before the clipping, see LarvaSynth2::MixOut
+//#define MIX_LINEAR_KNEE
+
+// golden render regression check at startup instead of normal operation, see RenderCheck.hpp
+//#define RENDER_CHECK
+
+// Timebase
+// control ticks (counted in updateControl, passed down through Update()) 
+// and audio samples (counted in updateAudio) replace millis()
+
+// ticks covering at least acMs
+static constexpr uint32_t MsToTicks( const uint32_t acMs ){
+    return ( acMs * CONTROL_RATE + 999 ) / 1000;
+}
+
+static constexpr uint32_t SamplesToMs( const uint64_t acSamples ){
+    return (uint32_t)( acSamples * 1000 / AUDIO_RATE );
+}
 
 enum ChordID { 
     kChord1=0,
@@ -88,6 +164,17 @@ static const float* cChords[kNumChords] = {
 // num strings for each Chord
 static const int cNumStrings = 3;
 
+// Output stage: chords mix in float, already in 16 bit output units (the scaling is folded
+// in the chord gain), one conversion to int32 per sample, saturated to int16 (PT8211)
+static constexpr float cMixOutScale = 32000.f; // full chord mix 1.0 --> output
+static const int32_t cMixKnee = 24576;         // MIX_LINEAR_KNEE: 0.75 FS, slope 1/4 above
+static const int cMixKneeShift = 2;            // input 57344 reaches FS
+
+// polyphony cap: max sustained chords, the lowest priority one beyond it is released
+// (see LarvaSynth2::LimitPolyphony); released chords fade out over cChordReleaseTicks
+static const int cNumActiveChordsMax = 3;
+static const uint32_t cChordReleaseTicks = MsToTicks( 250 );
+
 // num partials for each string
 static const int cNumPartials = 12;
 
@@ -133,6 +220,12 @@ static const float cLFOrate[cNumStrings] = { 0.10f, 0.045f, 0.06f }; // 0.5f, 0.
 static const int cLFOsr = 6; // lfo samplerate
 static const int cLFOUpdateInterval = CONTROL_RATE / cLFOsr;
 
+// multirate drone (DRONE_MULTIRATE): sub rate factor and partial freq limit.
+// The low band is upsampled by linear interpolation, images of a partial at f 
+// land at AUDIO_RATE / cDroneSubRate - f, e.g. 15.4kHz for 1kHz @ x2 (-48dB)
+static const int cDroneSubRate = 2;
+static const float cDroneSubRateCutoff = 1000.f;
+
 // drone gain smoothing factor
 static const float gcSmoothness = 0.975f; 
 
@@ -142,6 +235,8 @@ static const int cDroneRange[cNumStrings] = { 1100*TMul, 1100*TMul, 1100*TMul};
 static const int cDroneDecreaseStep[cNumStrings] = { 5*TMul, 6*TMul, 7*TMul };
 static const int cDroneDecreaseRate = 20; // ms
 
+static const int cDroneDecreaseTicks = MsToTicks( cDroneDecreaseRate );
+
 // Decrease step mult factor vs freq curve
 const float cDecrCutoff = 800.f;    // decrease step of freqs above this cutoff is scaled
 const float cDecrFreqMax = 6000.f;  // freq at which gain will be min
@@ -161,6 +256,14 @@ static const int cPlokImpulseDurRange = 20;
 
 static const float cPlokDurEstimMs = 50.f;
 
+// plok coefficient tables, see Plok.hpp
+static const int cPlokSinTableSize = 512;  // sin over [0,pi/2]
+static const int cPlokExpTableSize = 1024; // exp(-x) over [0,pi]
+
+// shared excitation noise, see Plok.hpp
+static const int cPlokNoiseTableSize = 1024; // power of 2
+static const int cPlokNoiseRefillSize = 16;  // entries renewed per control tick
+
 static constexpr float cPulseGainL = 14.f;
 static constexpr float cPulseGainM = 6.f;
 static constexpr float cPulseGainS = 2.f;
@@ -192,6 +295,7 @@ static const int cPulseS_treshold[cNumStrings] = { 500*TMul, 800*TMul, 1000*TMul
 
 // time interval for computing triggers average (ms)
 static const long cTriggersinterval = 1000;
+static const uint32_t cTriggersintervalTicks = MsToTicks( cTriggersinterval );
 static const int cTriggersRollingSize = 30;
 
 // "low activity" thres (ntriggers/interval)
@@ -232,12 +336,17 @@ static const int cDeltaScalerMax = 20000;
 // sets sensitivity to light changes
 static const int cLightTriggerTreshold = 80; // 25
 
-// photosens out range
-static const float cLightRange = 1050.f; 
+// photosens out range: cLightRange, in LuxScaler.hpp (shared with host tools)
 
 // Photo Sensor Pin
 static const int cPhotoSensPin = 34; 
 
+// background acquisition (SENSOR_OVERSAMPLE, see LightSampler.hpp)
+// sample rate --> fast rate (CIC) --> control rate (anti-alias FIR)
+static const int cSensorSampleRate = 2048;
+static const int cSensorFastDecim = 4; // 512Hz fast stream
+static const int cSensorCtrlDecim = cSensorSampleRate / cSensorFastDecim / CONTROL_RATE;
+
 // Light sensor gain calibration
 
 // mov avg size on raw input for calibrating the gain
@@ -249,9 +358,67 @@ static const int cGainCalibAvgSize = 128; // @64 = 2s
 static const int mLuxRawAvgThresMin = 1000;
 static const int mLuxRawAvgThresMax = 3000;
 
+// gain calibration strategy
+enum GainCalibMode {
+    kGainCalibStep=0,   // +-cGainStep every cGainModPeriodMs, up to 25s for a full swing
+    kGainCalibModel     // target gain from raw = lux * (gain+1), settles in a few steps of 0.5s
+};
+static const GainCalibMode cGainCalibMode = kGainCalibModel;
+
+// kGainCalibModel: raw value the computed gain aims at (centre of the range above)
+static const int cLuxRawTarget = 2000;
+
+// kGainCalibModel: search stops with the avg in this range, inside the one above
+static const int cLuxRawStopMin = 1400;
+static const int cLuxRawStopMax = 2600;
+
+// kGainCalibModel: ticks averaged at each gain of the search
+static const int cGainCalibDwellTicks = 32; // @64 = 0.5s
+
+// kGainCalibModel: ticks skipped after a gain change, before the pot is written
+// and, with SENSOR_OVERSAMPLE, while the decimator still holds samples of the
+// old gain (its FIR spans 8 control periods)
+#if defined(SENSOR_OVERSAMPLE)
+static const int cGainCalibSettleTicks = 2 + 8;
+#else
+static const int cGainCalibSettleTicks = 2;
+#endif
+
+// Profiler report interval (control ticks)
+static const int cProfReportInterval = 10 * CONTROL_RATE; // 10s
+static const unsigned long cProfBaud = 115200;
+
+// Telemetry settings
+static const unsigned long cTelemetryBaud = 115200;
+static const unsigned cTelemetryBufSize = 1024; // bytes, power of 2
+static const int cTelemetryInterval = 4; // control ticks per record, 34 bytes @ 16Hz
+
+// Load governor settings (LOAD_GOVERNOR)
+// load = busy fraction of the control period (audio + control), see LoadMeter.hpp
+static const float cLoadShedHigh = 0.85f;   // above: shed one more level each tick
+static const float cLoadShedLow = 0.65f;    // below for cLoadRestoreTicks: restore one level
+static const uint32_t cLoadRestoreTicks = MsToTicks( 500 );
+// each level drops one partial and one plok voice per string
+static const int cLoadShedMaxLevel = 8;
+
+// Light trace recorder settings
+static const char* const cLightTracePath = "/trace.klt";
+static const int cLightTraceBlockSize = 512;
+static const int cLightTraceNumBlocks = 4;
+// max error on the recorded raw (ADC counts), hides +-2 LSB noise (see LightTraceCodec.hpp)
+static const int cLightTraceDeadBand = 3;
+// fits the default SPIFFS partition: ~1.9 days of noisy input (+-2 LSB), ~12 days of steady light
+static const uint32_t cLightTraceMaxBytes = 1200 * 1024UL;
+
+// Render check output
+static const unsigned long cRenderCheckBaud = 115200;
+
 // Amp enable pin
 static const int cAmpEnablePin = 17;
 
+// digipot SPI clock (MCP4151 max 10MHz)
+static const uint32_t cDigiPotSpiClock = 1000000;
+
 // gain range
 static const int cGainMin = 0;
 static const int cGainMax = 255;
@@ -261,6 +428,7 @@ static const int cGainStep = 1;
 
 // gain update period (ms)
 static const unsigned long cGainModPeriodMs = 100;
+static const uint32_t cGainModPeriodTicks = MsToTicks( cGainModPeriodMs );
 
 static const int cFreq2GainTableSize = 128;
 static const float cFreq2GainTableRange = cFreqMax - cFreqCutoff + 1.f;
@@ -15,13 +15,17 @@
 
 #include <MozziGuts.h>
 #include <RollingAverage.h>
-#include <Smooth.h>
+#include <mozzi_fixmath.h>
 #include <mozzi_rand.h>
 #include <ADSR.h>
 #include <Oscil.h>
 #include <tables/sin2048_int8.h>
 #include "Plok.hpp"
+#include "DroneWavetable.hpp"
+#include "RecursiveSineBank.hpp"
+#include "RandStream.hpp"
 #include "LarvaDefs.hpp"        
+#include "Profiler.hpp"
 
 extern float mFreq2GainTable[cFreq2GainTableSize];
 
@@ -56,6 +60,31 @@ private:
     long int hperiod{1};
 };
 
+// one pole gain smoother, same arithmetic as Mozzi Smooth<unsigned int>,
+// which has no way to set its state: Init() restarts from 0
+class GainSmooth{
+
+public:
+
+    GainSmooth(){}
+    ~GainSmooth(){}
+
+    inline void Init(const float acSmoothness){
+        a = float_to_Q0n16(1.f - acSmoothness);
+        last_out = 0;
+    }
+
+    inline unsigned int Next(const unsigned int acIn){
+        long vout = ((((long)acIn - (last_out >> 8)) * a) >> 8) + last_out;
+        last_out = vout;
+        return (unsigned int)(vout >> 8);
+    }
+
+private:
+    long last_out{0};
+    Q0n16 a{0};
+};
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 class LarvaString
 {
@@ -67,12 +96,34 @@ public:
     // callme @sr
     inline float Process(){
 
+        #if defined(DRONE_WAVETABLE)
+        float vsum = (float)mWave.Next();
+        #elif defined(DRONE_RECURSIVE)
+        float vsum = mBank.Next( mProcPartials, mNumProcPartials );
+        #else
         float vsum = 0.f;
-        for ( int i=0; i < cNumPartials; ++i ){
+        for ( int n=0; n < mNumProcPartials; ++n ){
+            int i = mProcPartials[n];
             float vosc = (float)( mSin[i].next() * mSmoothGains[i] );
             vsum += vosc;
         }
 
+        #ifdef DRONE_MULTIRATE
+        // low partials: one sample every cDroneSubRate, linear ramp towards it
+        if ( --mSubRateCounter <= 0 ){
+            mSubRateCounter = cDroneSubRate;
+            float vlow = 0.f;
+            for ( int n=0; n < mNumLowPartials; ++n ){
+                int i = mLowPartials[n];
+                vlow += (float)( mSin[i].next() * mSmoothGains[i] );
+            }
+            mLowStep = ( vlow - mLowOut ) * ( 1.f / cDroneSubRate );
+        }
+        mLowOut += mLowStep;
+        vsum += mLowOut;
+        #endif
+        #endif // drone engine
+
         vsum *= cStringDroneGainScaler;
         vsum += mPlokSynth.Process();
         
@@ -95,7 +146,7 @@ public:
     inline void Unmute(){ 
         if (mActive==false){
             //Serial.print("-- Unmuting String "); Serial.println(mID);
-            Retune(mFundFreq); 
+            RetuneNext(); 
             mActive=true; 
             mTriggered=true;
         } 
@@ -104,17 +155,66 @@ public:
     inline bool Active(){ return mActive; }
     inline bool Triggered(){ return mTriggered; }
     
+    // num of non silent partials
+    inline int NumActivePartials(){
+        int vn = 0;
+        for ( int i = 0; i < cNumPartials; ++i ){
+            vn += mSmoothGains[i] > 0 ? 1 : 0;
+        }
+        return vn;
+    }
+
+    inline int NumActivePloks(){ return mPlokSynth.NumActiveVoices(); }
+
+    // sum of the smoothed partial gains
+    inline int Energy(){
+        int ve = 0;
+        for ( int i = 0; i < cNumPartials; ++i ){
+            ve += mSmoothGains[i];
+        }
+        return ve;
+    }
+
+    // silence now: levels, gains & smoothers to 0, muted & idle
+    void Reset();
+
+    // load shedding, see LoadGovernor.hpp
+    // level n caps the sounding partials to cNumPartials - n (the quietest
+    // ones are faded out) and the plok voices, see PlokSynth::SetShedLevel
+    inline void SetShedLevel( const int acLevel ){
+        mShedPartials = acLevel < cNumPartials ? acLevel : cNumPartials - 1;
+        mPlokSynth.SetShedLevel( acLevel );
+    }
+
+    // immediate retune
     void Retune(const float acFundamental);
 
+    // fundamental for the next unmute, the tuning is pre-rolled while muted
+    inline void SetNextFundamental(const float acFundamental){
+        if ( acFundamental != mNextFund ){
+            mNextFund = acFundamental;
+            mRetuneReady = false;
+        }
+    }
+
+    // callme @kr, spread over ticks by the caller (see LarvaSynth2::Update)
+    // computes the next tuning while muted, so Unmute() only swaps it in.
+    // true if there was work to do
+    inline bool PrerollRetune(){
+        if ( mActive || mRetuneReady ){
+            return false;
+        }
+        PrepareTuning(mNextFund);
+        return true;
+    }
+
     void SetLightRange(const int acMin, const int acMax ){ 
 
-        // compute light ranges for each partial
+        // light ranges for each partial: 
+        // [ min + i * range12, min + (i+1) * range12 )
         int vrange = acMax - acMin;
-        int vrange12 = vrange / cNumPartials; 
-        for (int i = 0; i < cNumPartials; i++) {         
-            mLightRangeMin[i] = acMin + ( i * vrange12 );
-            mLightRangeMax[i] = acMin + ( (i+1) * vrange12 );  
-        }
+        mLightRangeMin = acMin;
+        mLightRange12 = vrange / cNumPartials; 
     }
 
     inline void SetID(const int acValue){ mID = acValue; }
@@ -141,6 +241,30 @@ public:
 
 private:    
     void UpdateCutoffLevel();
+    void ShedPartials();
+    void RetuneNext();
+    void PrepareTuning(const float acFundamental);
+    void ApplyTuning();
+
+    // oscillator freqs from mFreq, sub rate partials run at x cDroneSubRate
+    inline void SetOscFreqs(){
+        #if defined(DRONE_WAVETABLE)
+        mWave.SetFreqs(mFreq);
+        #elif defined(DRONE_RECURSIVE)
+        mBank.SetFreqs(mFreq);
+        #else
+        for ( int i = 0; i < cNumPartials; ++i ){
+            #ifdef DRONE_MULTIRATE
+            mSubRate[i] = mFreq[i] < cDroneSubRateCutoff;
+            if ( mSubRate[i] ){
+                mSin[i].setFreq( mFreq[i] * cDroneSubRate );
+                continue;
+            }
+            #endif
+            mSin[i].setFreq( mFreq[i] );
+        }
+        #endif
+    }
     void TriggerRandomPulse( const int acVoice, const float acFreq, const float acGain );
     
     // :TODO: tabulate
@@ -164,18 +288,41 @@ private:
     int mID{0};
     bool mActive{false};
     bool mTriggered{false};
-    bool retune_ready;
+    bool mIdle{false}; // silent & muted, Update() skips it until the levels are bumped
     float mFundFreq{333.f};
-    float mBaseFreq[cNumPartials];
-    float mDetune[cNumPartials];
-    float mFreq[cNumPartials];
+    float mBaseFreq[cNumPartials]{};
+    float mDetune[cNumPartials]{};
+    float mFreq[cNumPartials]{};
+
+    // next tuning, valid if mRetuneReady
+    bool mRetuneReady{false};
+    float mNextFund{333.f};
+    int mNextCutoffPartial{1};
+    float mNextBaseFreq[cNumPartials]{};
+    float mNextDetune[cNumPartials]{};
+    int mNextDecreaseStep[cNumPartials]{};
 
     static const int mNumPartials{cNumPartials};
     Oscil<SIN2048_NUM_CELLS, AUDIO_RATE> mSin[cNumPartials];
-    Smooth <unsigned int> mSmooth[cNumPartials];
+    GainSmooth mSmooth[cNumPartials];
         
-    byte mGains[cNumPartials]; // 0-255 8bit for speed
-    byte mSmoothGains[cNumPartials];
+    byte mGains[cNumPartials]{}; // 0-255 8bit for speed
+    byte mSmoothGains[cNumPartials]{};
+
+    // partials rendered by Process(), all of them unless shedding
+    int mProcPartials[cNumPartials]{};
+    int mNumProcPartials{0};
+    int mShedPartials{0};
+
+    #ifdef DRONE_MULTIRATE
+    // sub rate partials, rendered separately
+    bool mSubRate[cNumPartials]{};
+    int mLowPartials[cNumPartials]{};
+    int mNumLowPartials{0};
+    int mSubRateCounter{0};
+    float mLowOut{0.f};
+    float mLowStep{0.f};
+    #endif
     
     int mNumTriggeredEvents{0};
     static const int cNumTriggeredEventsThresh = 1000;
@@ -185,6 +332,15 @@ private:
     int mCutoffPartial{1};
 
     PlokSynth mPlokSynth;
+
+    #if defined(DRONE_WAVETABLE)
+    DroneWavetable<cNumPartials> mWave;
+    #elif defined(DRONE_RECURSIVE)
+    RecursiveSineBank<cNumPartials> mBank;
+    #endif
+
+    // tuning & plok dithering
+    RandStream mRand;
     
     // master gain controlled by triggers activity 
     float mPulseMasterGain{1.f};
@@ -193,23 +349,26 @@ private:
     // Fix 29/4 - chance of negative q setting on startup
     float mPulseResonanceAvg{cPulseResonanceMin};
 
-    int mPulseL_levels[cNumPartials];
-    int mPulseM_levels[cNumPartials];
-    int mPulseS_levels[cNumPartials];
+    int mPulseL_levels[cNumPartials]{};
+    int mPulseM_levels[cNumPartials]{};
+    int mPulseS_levels[cNumPartials]{};
 
     int mPulseL_treshold{0};
     int mPulseM_treshold{0};
     int mPulseS_treshold{0};
 
-    int mDroneLevels[cNumPartials]; // 0-1000
+    // decay is evaluated lazily: level = stored value - step * periods since stamp
+    // the clock only runs while the string is active
+    int mDroneLevels[cNumPartials]{}; // 0-1000, value @ mDroneStamp
+    uint32_t mDroneStamp[cNumPartials]{};
+    uint32_t mDecayClock{0};
     int mDroneRange{0};
     int mDroneDecreaseStepMaster{66};
-    int mDroneDecreaseStep[cNumPartials];
-    unsigned long mDecreaseTime;
+    int mDroneDecreaseStep[cNumPartials]{};
     
-    // light ranges for each partial
-    int mLightRangeMin[cNumPartials];
-    int mLightRangeMax[cNumPartials];
+    // light ranges for each partial, see SetLightRange()
+    int mLightRangeMin{0};
+    int mLightRange12{0};
 
     LFO mLFO;
     
@@ -218,6 +377,20 @@ private:
     // scale by 1 / ( npartials * 32640 ) * master
     static constexpr float cStringDroneGainScaler = 1.f / ( cNumPartials * 32640.f ) * cDroneMasterGain;
 
+    // decayed drone level, now
+    inline int DroneLevel( const int acPartial ){
+        int vperiods = ( mDecayClock - mDroneStamp[acPartial] ) / cDroneDecreaseTicks;
+        int64_t vdecay = (int64_t)vperiods * mDroneDecreaseStep[acPartial];
+        return vdecay >= mDroneLevels[acPartial] ? 0 : mDroneLevels[acPartial] - (int)vdecay;
+    }
+
+    // stores the decayed level and restamps, keeping the decay phase 
+    // (all partials decay on the same ticks). callme before a level or step change
+    inline void FoldDroneLevel( const int acPartial ){
+        mDroneLevels[acPartial] = DroneLevel(acPartial);
+        mDroneStamp[acPartial] = mDecayClock - ( mDecayClock - mDroneStamp[acPartial] ) % cDroneDecreaseTicks;
+    }
+
     byte Freq2GainScaler(const float acFreq, byte acGain){
 
         float vdf = acFreq - cFreqCutoff;
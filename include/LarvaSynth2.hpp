@@ -15,6 +15,7 @@
 
 #include "LarvaDefs.hpp"
 #include "LarvaChord.hpp"
+#include "Profiler.hpp"
 
 class LarvaSynth2
 {
@@ -23,24 +24,71 @@ public:
     LarvaSynth2(){}
     ~LarvaSynth2(){}
 
-    // callme @setup
-    void Init();
+    // callme @setup, then Start()
+    void Init( const unsigned long acSeed = 0 );
     
     // callme @sr
     int16_t Process();
 
     // callme @kr
-    void Update( const int acLightRaw, const int acLightScaled );
+    // acTick: control tick counter
+    // acLightGain: sensor gain of acLightRaw, a change mutes the delta triggers for a while
+    void Update( const uint32_t acTick, const int acLightRaw, const int acLightScaled, const int acLightGain );
 
     inline void Start(){ startMozzi(CONTROL_RATE); }
     inline void Stop(){ stopMozzi(); }
 
+    // load shedding, see LoadGovernor.hpp
+    // callme @kr when the level changes, 0 = full synthesis
+    inline void SetShedLevel( const int acLevel ){
+        for ( int s = 0; s < kNumChords; ++s ){
+            mChords[s].SetShedLevel( acLevel );
+        }
+    }
+
+    // instrumentation
+    inline float GetDeltaScaler(){ return mDeltaScaler; }
+    inline int GetTriggersAvg(){ return mTriggersAvg; }
+    inline float GetPulseGain(){ return mPulseGain; }
+    inline float GetPulseRes(){ return mPulseRes; }
+    inline int NumActiveChords(){ return mNumActiveChords; }
+
+    // output stage: samples clipped since start, 
+    // peak |mix| before saturation since the last call (full scale 32767)
+    inline uint32_t GetClipCount(){ return mClipCount; }
+    inline int32_t TakePeak(){ 
+        int32_t vpeak = mPeak;
+        mPeak = 0;
+        return vpeak; 
+    }
+
+    // totals over the active chords
+    void CountVoices( int& aNumStrings, int& aNumPartials, int& aNumPloks );
+
 private:
 
+    void LimitPolyphony( const int acLightSlowAvg );
+
+    // int32 mix --> 16 bit output: optional linear knee, saturation, metering
+    inline int16_t MixOut( const int32_t acMix ){
+        int32_t vabs = acMix < 0 ? -acMix : acMix;
+        mPeak = vabs > mPeak ? vabs : mPeak;
+        #ifdef MIX_LINEAR_KNEE
+        if ( vabs > cMixKnee ){
+            vabs = cMixKnee + ( ( vabs - cMixKnee ) >> cMixKneeShift );
+        }
+        #endif
+        if ( vabs > 32767 ){
+            vabs = 32767;
+            mClipCount++;
+        }
+        return (int16_t)( acMix < 0 ? -vabs : vabs );
+    }
+
     inline float BellCurve( const float acIn, const float acInMin, const float acInMax,
                     const float acOutMin, const float acOutMax )
     {
-        float vin = acIn < acInMin ? acInMin : vin;
+        float vin = acIn < acInMin ? acInMin : acIn;
         vin = vin > acInMax ? acInMax : vin;
         float vinorm = (vin - acInMin) / ( acInMax - acInMin );
         float vout = acOutMin + ( 1.f - cosf( 2.f*PI*vinorm) ) * 0.5f * ( acOutMax - acOutMin );
@@ -56,7 +104,7 @@ private:
 
     // Chords
     LarvaChord mChords[kNumChords];
-    LarvaChord* mpActiveChords[kNumChords];
+    LarvaChord* mpActiveChords[kNumChords]{};
     int mNumActiveChords{0};
 
     // Light input process
@@ -64,11 +112,13 @@ private:
     RollingAverage<int, cChordChangeLightAvgSize> mLightSlowRolling; 
     RollingAverage<int, cLightRollingSize> mLightRolling;
     RollingAverage<int, cDeltaRollingSize> mDeltaRolling; 
+    int mLightGain{0};
+    int mLightGainHold{0};
 
     // Triggers avg over last n seconds
     int mTriggersAvg{0};
     int mTriggersCounter{0};
-    int mTriggersTimestamp{0};
+    uint32_t mTriggersTick{0};
     RollingAverage<int, cTriggersRollingSize> mTriggersRolling; 
 
     // master controls for Pulse gain and resonance
@@ -79,13 +129,17 @@ private:
     static const int cLightExcursionInterval = cLightExcursionIntervalSecs * CONTROL_RATE;
     int mCurLightMin{INT_MAX};
     int mCurLightMax{0};
-    int mLightMin[cLightExcursionIntervalSecs];
-    int mLightMax[cLightExcursionIntervalSecs];
+    int mLightMin[cLightExcursionIntervalSecs]{};
+    int mLightMax[cLightExcursionIntervalSecs]{};
     int mLightExcursionTimer{0};
     int mLightExcursion{0};
 
+    // output metering
+    uint32_t mClipCount{0};
+    int32_t mPeak{0};
+
     // serial printing counter
-    int p_count; 
+    int p_count{0}; 
 };
 
 
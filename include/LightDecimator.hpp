@@ -0,0 +1,166 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Sensor decimator
+//
+// sample rate --> fast rate: 2nd order CIC, decimation TFastDecim
+// fast rate --> control rate: anti-alias lowpass, one output every
+// TCtrlDecim fast values. Windowed sinc, 8 x TCtrlDecim taps, cutoff at
+// 0.625 x the control nyquist, Kaiser window (beta 4.5), Q15 integer
+// taps summing to unity gain.
+//
+// Output keeps the input range (ADC counts). The history is primed with
+// the first value after a reset, so a steady input comes out unchanged.
+//
+// Response at the control output, 2048 Hz in, 4 x 8 decimation
+// (see tools/LightDecimatorCheck.cpp): -0.6dB @ 10Hz, -0.9dB @ 12Hz,
+// -2.3dB @ 16Hz, -13dB @ 24Hz, below -50dB from 32Hz (control nyquist)
+// up, thus flicker above it does not fold back into the control rate.
+// Group delay 62ms.
+// No Arduino dependencies.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+static const int cLightDecimOutMax = 4095; // ADC range
+
+template <int TFastDecim, int TCtrlDecim>
+class LightDecimator
+{
+public:
+    LightDecimator(){ InitTaps(); }
+    ~LightDecimator(){}
+
+    inline void Reset(){
+        mInteg1 = mInteg2 = mPrevInteg2 = 0;
+        mPrevComb1 = 0;
+        mPhase = 0;
+        mPrimed = false;
+        mFilled = false;
+        mHistInd = 0;
+        mNumFast = 0;
+    }
+
+    // one input sample, true when a new control rate value is ready
+    inline bool Push( const int acSample ){
+
+        // integrators wrap around, the combs undo it
+        mInteg1 += (uint32_t)acSample;
+        mInteg2 += mInteg1;
+
+        if ( ++mPhase < TFastDecim ){
+            return false;
+        }
+        mPhase = 0;
+
+        int32_t vcomb1 = (int32_t)( mInteg2 - mPrevInteg2 );
+        mPrevInteg2 = mInteg2;
+        int32_t vcomb2 = vcomb1 - mPrevComb1;
+        mPrevComb1 = vcomb1;
+
+        // the first output after a reset lacks the comb history
+        if ( !mPrimed ){
+            mPrimed = true;
+            return false;
+        }
+
+        int vfast = ( vcomb2 + cCicGain / 2 ) / cCicGain;
+        if ( !mFilled ){
+            mFilled = true;
+            for ( int i = 0; i < cNumTaps; ++i ){
+                mHist[i] = vfast;
+            }
+        }
+        mHist[mHistInd] = vfast;
+        mHistInd = mHistInd + 1 < cNumTaps ? mHistInd + 1 : 0;
+
+        if ( ++mNumFast < TCtrlDecim ){
+            return false;
+        }
+        mNumFast = 0;
+
+        // oldest value first, mHistInd points at it
+        int32_t vacc = 0;
+        int vi = mHistInd;
+        for ( int k = 0; k < cNumTaps; ++k ){
+            vacc += mTaps[k] * mHist[vi];
+            vi = vi + 1 < cNumTaps ? vi + 1 : 0;
+        }
+        int vout = ( vacc + ( 1 << ( cTapBits - 1 ) ) ) >> cTapBits;
+        mValue = vout < 0 ? 0 : ( vout > cLightDecimOutMax ? cLightDecimOutMax : vout );
+        return true;
+    }
+
+    // last control rate value
+    inline int Value(){ return mValue; }
+
+    static const int cNumTaps = 8 * TCtrlDecim;
+
+private:
+
+    // symmetric taps, rounding error folded in the centre ones for an exact unity gain
+    void InitTaps(){
+        const float vfc = 0.3125f / TCtrlDecim; // cycles per fast value
+        const float vbeta = 4.5f;
+        const float vhalf = 0.5f * ( cNumTaps - 1 );
+        float vtaps[cNumTaps];
+        float vsum = 0.f;
+        for ( int k = 0; k < cNumTaps; ++k ){
+            float vm = (float)k - vhalf;
+            float vsinc = sinf( 6.2831853f * vfc * vm ) / ( 3.1415927f * vm );
+            float vr = vm / vhalf;
+            float vwin = BesselI0( vbeta * sqrtf( 1.f - vr * vr ) ) / BesselI0( vbeta );
+            vtaps[k] = vsinc * vwin;
+            vsum += vtaps[k];
+        }
+        int32_t vqsum = 0;
+        for ( int k = 0; k < cNumTaps; ++k ){
+            mTaps[k] = (int32_t)floorf( vtaps[k] / vsum * ( 1 << cTapBits ) + 0.5f );
+            vqsum += mTaps[k];
+        }
+        int32_t vrest = ( 1 << cTapBits ) - vqsum;
+        mTaps[cNumTaps / 2 - 1] += vrest / 2;
+        mTaps[cNumTaps / 2] += vrest - vrest / 2;
+    }
+
+    // modified Bessel function of the first kind, order 0 (power series)
+    static float BesselI0( const float acX ){
+        float vsum = 1.f;
+        float vterm = 1.f;
+        for ( int k = 1; k < 20; ++k ){
+            float vq = acX / ( 2.f * k );
+            vterm *= vq * vq;
+            vsum += vterm;
+        }
+        return vsum;
+    }
+
+private:
+    static const int32_t cCicGain = TFastDecim * TFastDecim;
+    static const int cTapBits = 15;
+
+    uint32_t mInteg1{0};
+    uint32_t mInteg2{0};
+    uint32_t mPrevInteg2{0};
+    int32_t mPrevComb1{0};
+    int mPhase{0};
+    bool mPrimed{false};
+
+    int32_t mTaps[cNumTaps];
+    int mHist[cNumTaps]{};
+    int mHistInd{0};
+    bool mFilled{false};
+    int mNumFast{0};
+
+    int mValue{0};
+};
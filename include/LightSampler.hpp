@@ -0,0 +1,54 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Background photosensor acquisition
+//
+// samples the photodiode @ cSensorSampleRate from a periodic esp_timer
+// (timer task, core 0), so the loop on core 1 never waits for the ADC.
+// I2S0 drives the DAC, thus ADC DMA (I2S0 only on ESP32) is not an option.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "Arduino.h"
+#include <esp_timer.h>
+#include "LarvaDefs.hpp"
+#include "OversampledLightSource.hpp"
+
+// photodiode @ sample rate, decimated to control rate
+typedef OversampledLightSource<cSensorFastDecim, cSensorCtrlDecim> SensorLightSource;
+
+class LightSampler
+{
+public:
+    LightSampler(){}
+    ~LightSampler(){}
+
+    // callme @ setup, after the source Init()
+    bool Start( SensorLightSource* apSource ){
+        esp_timer_create_args_t vargs;
+        vargs.callback = &OnTimer;
+        vargs.arg = apSource;
+        vargs.dispatch_method = ESP_TIMER_TASK;
+        vargs.name = "lightsampler";
+        if ( esp_timer_create( &vargs, &mTimer ) != ESP_OK ){
+            return false;
+        }
+        return esp_timer_start_periodic( mTimer, 1000000UL / cSensorSampleRate ) == ESP_OK;
+    }
+
+private:
+    static void OnTimer( void* apSource ){
+        ( (SensorLightSource*)apSource )->Sample();
+    }
+
+private:
+    esp_timer_handle_t mTimer{NULL};
+};
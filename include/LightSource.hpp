@@ -0,0 +1,109 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Light source interface
+//
+// what PhotoSensReader reads from: one raw reading [0,4095] per
+// control tick, taken with the preamp gain [0,255] last set.
+// Implementations:
+//  - AdcLightSource (AdcLightSource.hpp): photodiode, ADC + digipot
+//  - ReplayLightSource: recorded light trace
+//  - Cloud/Flicker/Step/SaturationLightSource (SynthLightSources.hpp)
+// No Arduino dependencies.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "LightTraceCodec.hpp"
+
+static const int cLightSourceRawMax = 4095;
+static const int cLightSourceGainMax = 255;
+
+class LightSource
+{
+public:
+    virtual ~LightSource(){}
+
+    // callme @ setup
+    virtual void Init(){}
+
+    // callme @kr, raw reading with the current gain
+    virtual int Read() = 0;
+
+    // preamp gain, applies from the next Read()
+    virtual void SetGain( const int acGain ){ mGain = acGain; }
+    inline int GetGain(){ return mGain; }
+
+    // callme @ loop, completes deferred work (e.g. the digipot write)
+    // outside the audio and control callbacks
+    virtual void Flush(){}
+
+protected:
+    int mGain{0};
+};
+
+//---------------------------------------------------------
+// sources defined by a physical light level.
+// Preamp model, as in PhotoSensReader: raw = lux * (gain + 1), clipped to the ADC range,
+// lux in raw counts @ gain 0
+class ModelLightSource : public LightSource
+{
+public:
+    virtual ~ModelLightSource(){}
+
+    virtual int Read(){
+        float vraw = NextLux() * (float)( mGain + 1 );
+        vraw = vraw < 0.f ? 0.f : vraw > (float)cLightSourceRawMax ? (float)cLightSourceRawMax : vraw;
+        return (int)( vraw + 0.5f );
+    }
+
+protected:
+    // light level for this tick
+    virtual float NextLux() = 0;
+};
+
+//---------------------------------------------------------
+// replays a recorded trace (LightTraceRecorder), TSource as in LightTraceDecoder.
+// While the reader's gain matches the recorded one the recorded raw values
+// come out unchanged, otherwise they are rescaled through the preamp model.
+// Holds the last value at the end of the trace.
+template <class TSource>
+class ReplayLightSource : public LightSource
+{
+public:
+    ReplayLightSource( TSource& aSource ) : mDecoder(aSource) {}
+    virtual ~ReplayLightSource(){}
+
+    virtual int Read(){
+
+        int vraw, vgain;
+        if ( mDecoder.Next( vraw, vgain ) ){
+            mRecRaw = vraw;
+            mRecGain = vgain;
+        }
+        else {
+            mDone = true;
+        }
+
+        if ( mGain == mRecGain ){
+            return mRecRaw;
+        }
+        long vscaled = ( (long)mRecRaw * ( mGain + 1 ) + ( mRecGain + 1 ) / 2 ) / ( mRecGain + 1 );
+        return vscaled > cLightSourceRawMax ? cLightSourceRawMax : (int)vscaled;
+    }
+
+    inline bool Done(){ return mDone; }
+
+private:
+    LightTraceDecoder<TSource> mDecoder;
+    int mRecRaw{0};
+    int mRecGain{0};
+    bool mDone{false};
+};
@@ -0,0 +1,376 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Light trace codec
+//
+// compact log of the sensor input, one entry per control tick:
+// raw ADC reading + digipot gain. The scaled light is not stored,
+// it is a pure function of the two (LuxScale).
+// No Arduino dependencies, shared by the firmware recorder and host tools.
+//
+// stream = header + ops
+// header: 'K' 'L' 'T' version, control rate (u16 LE), 2 bytes reserved
+//
+// ops (d = raw delta vs previous tick, zz = zigzag encoded):
+//  00aaabbb  two ticks, d in [-4,3] each (a first)
+//  01dddddd  one tick, d in [-32,31]
+//  10nnnnnn  n+1 ticks with unchanged raw (1..64)
+//  0xE0 g    gain change, applies to the following ticks
+//  0xE1 v..  one tick, zz(d) as LEB128 varint
+//  0xE2 r r g keyframe: absolute raw (u16 LE) & gain, resets the predictor
+//  0xE3 v..  gap: varint n ticks not recorded (e.g. recorder overflow)
+//
+// Encoder dead band: raw changes up to +-acDeadBand from the last written
+// value are stored as unchanged, so noise turns into runs. Keyframes and
+// ticks with a gain change stay exact. The decoder is the same either way,
+// 0 is lossless.
+// +-2 LSB ADC noise: ~0.57 byte/tick lossless, ~0.12 with a dead band of 3
+// (a day ~640 KB, see cLightTraceMaxBytes); steady light ~0.02, flicker 1 or more.
+// Round trip check: tools/LightTraceCodecCheck.cpp
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const uint8_t cLightTraceVersion = 1;
+static const int cLightTraceHeaderSize = 8;
+
+// max bytes produced by one Encode()/Flush() call
+static const int cLightTraceMaxOpBytes = 16;
+
+// keyframe period, allows resync after a corrupted or truncated block
+static const uint32_t cLightTraceKeyframeInterval = 64 * 60; // 1 min @ 64Hz
+
+enum LightTraceOp {
+    kTraceOpGain = 0xE0,
+    kTraceOpVarint = 0xE1,
+    kTraceOpKeyframe = 0xE2,
+    kTraceOpGap = 0xE3,
+};
+
+inline int LightTraceWriteHeader( uint8_t* apOut, const int acControlRate ){
+    apOut[0] = 'K';
+    apOut[1] = 'L';
+    apOut[2] = 'T';
+    apOut[3] = cLightTraceVersion;
+    apOut[4] = (uint8_t)( acControlRate );
+    apOut[5] = (uint8_t)( acControlRate >> 8 );
+    apOut[6] = 0;
+    apOut[7] = 0;
+    return cLightTraceHeaderSize;
+}
+
+// returns the control rate, 0 if not a valid header
+inline int LightTraceReadHeader( const uint8_t* apIn ){
+    if ( apIn[0] != 'K' || apIn[1] != 'L' || apIn[2] != 'T' || apIn[3] != cLightTraceVersion ){
+        return 0;
+    }
+    return apIn[4] | ( apIn[5] << 8 );
+}
+
+//---------------------------------------------------------
+class LightTraceEncoder
+{
+public:
+    // acDeadBand: max error on raw (ADC counts), see above
+    LightTraceEncoder( const int acDeadBand = 0 ) : mDeadBand(acDeadBand) {}
+    ~LightTraceEncoder(){}
+
+    // restart, next tick is written as a keyframe
+    inline void Reset(){
+        mPending = false;
+        mRunLen = 0;
+        mTicksToKeyframe = 0;
+    }
+
+    // encodes one tick, returns num bytes written to apOut (<= cLightTraceMaxOpBytes)
+    int Encode( const int acRaw, const int acGain, uint8_t* apOut ){
+
+        int vn = 0;
+
+        if ( mTicksToKeyframe == 0 ){
+            vn += Flush( apOut );
+            apOut[vn++] = kTraceOpKeyframe;
+            apOut[vn++] = (uint8_t)( acRaw );
+            apOut[vn++] = (uint8_t)( acRaw >> 8 );
+            apOut[vn++] = (uint8_t)( acGain );
+            mPrevRaw = acRaw;
+            mGain = acGain;
+            mTicksToKeyframe = cLightTraceKeyframeInterval;
+        }
+        mTicksToKeyframe--;
+
+        int vd = acRaw - mPrevRaw;
+
+        if ( acGain != mGain ){
+            vn += Flush( apOut + vn );
+            apOut[vn++] = kTraceOpGain;
+            apOut[vn++] = (uint8_t)( acGain );
+            mGain = acGain;
+        }
+        else if ( vd >= -mDeadBand && vd <= mDeadBand ){
+            // the decoder keeps the last written value
+            vd = 0;
+        }
+        mPrevRaw += vd;
+
+        if ( mPending ){
+            if ( Fits3( mPendingDelta ) && Fits3( vd ) ){
+                apOut[vn++] = (uint8_t)( ( Zigzag( mPendingDelta ) << 3 ) | Zigzag( vd ) );
+                mPending = false;
+                return vn;
+            }
+            vn += WriteSingle( mPendingDelta, apOut + vn );
+            mPending = false;
+        }
+
+        if ( vd == 0 ){
+            if ( ++mRunLen == 64 ){
+                vn += WriteRun( apOut + vn );
+            }
+        }
+        else {
+            vn += WriteRun( apOut + vn );
+            mPending = true;
+            mPendingDelta = vd;
+        }
+        return vn;
+    }
+
+    // ticks that could not be stored, keeps the decoder time base aligned
+    int EncodeGap( const uint32_t acNumTicks, uint8_t* apOut ){
+        int vn = Flush( apOut );
+        apOut[vn++] = kTraceOpGap;
+        vn += WriteVarint( acNumTicks, apOut + vn );
+        // resync after the gap
+        mTicksToKeyframe = 0;
+        return vn;
+    }
+
+    // writes out buffered ticks
+    int Flush( uint8_t* apOut ){
+        int vn = 0;
+        if ( mPending ){
+            vn += WriteSingle( mPendingDelta, apOut );
+            mPending = false;
+        }
+        vn += WriteRun( apOut + vn );
+        return vn;
+    }
+
+private:
+
+    static inline uint32_t Zigzag( const int acValue ){
+        return ( (uint32_t)acValue << 1 ) ^ (uint32_t)( acValue >> 31 );
+    }
+
+    static inline bool Fits3( const int acValue ){ return acValue >= -4 && acValue <= 3; }
+
+    static inline int WriteVarint( uint32_t aValue, uint8_t* apOut ){
+        int vn = 0;
+        while ( aValue >= 0x80 ){
+            apOut[vn++] = (uint8_t)( aValue | 0x80 );
+            aValue >>= 7;
+        }
+        apOut[vn++] = (uint8_t)aValue;
+        return vn;
+    }
+
+    inline int WriteSingle( const int acDelta, uint8_t* apOut ){
+        if ( acDelta >= -32 && acDelta <= 31 ){
+            apOut[0] = (uint8_t)( 0x40 | Zigzag( acDelta ) );
+            return 1;
+        }
+        apOut[0] = kTraceOpVarint;
+        return 1 + WriteVarint( Zigzag( acDelta ), apOut + 1 );
+    }
+
+    inline int WriteRun( uint8_t* apOut ){
+        if ( mRunLen == 0 ){
+            return 0;
+        }
+        apOut[0] = (uint8_t)( 0x80 | ( mRunLen - 1 ) );
+        mRunLen = 0;
+        return 1;
+    }
+
+private:
+    const int mDeadBand;
+
+    int mPrevRaw{0};  // as seen by the decoder
+    int mGain{0};
+
+    bool mPending{false};
+    int mPendingDelta{0};
+    int mRunLen{0};
+
+    uint32_t mTicksToKeyframe{0};
+};
+
+//---------------------------------------------------------
+// byte source over a memory buffer, see LightTraceDecoder
+class LightTraceMemSource
+{
+public:
+    LightTraceMemSource( const uint8_t* apData, const size_t acSize )
+        : mpData(apData), mSize(acSize) {}
+
+    // next byte, -1 at end
+    inline int Read(){ return mPos < mSize ? mpData[mPos++] : -1; }
+
+private:
+    const uint8_t* mpData;
+    size_t mSize;
+    size_t mPos{0};
+};
+
+// pulls bytes from any TSource providing int Read() (-1 at end),
+// e.g. LightTraceMemSource or a file reader on device.
+// Expects the stream past the header.
+template <class TSource>
+class LightTraceDecoder
+{
+public:
+    LightTraceDecoder( TSource& aSource ) : mSource(aSource) {}
+    ~LightTraceDecoder(){}
+
+    // next tick, false at end of stream.
+    // aGap is set to true for ticks inside a gap: raw/gain repeat the last known value
+    bool Next( int& aRaw, int& aGain, bool& aGap ){
+
+        aGap = false;
+
+        while ( mRepeat == 0 && !mHasSecond && mGapLen == 0 ){
+            if ( !ReadOp() ){
+                return false;
+            }
+        }
+
+        if ( mGapLen > 0 ){
+            mGapLen--;
+            aGap = true;
+        }
+        else if ( mRepeat > 0 ){
+            mRepeat--;
+        }
+        else {
+            mRaw += mSecondDelta;
+            mHasSecond = false;
+        }
+
+        aRaw = mRaw;
+        aGain = mGain;
+        return true;
+    }
+
+    inline bool Next( int& aRaw, int& aGain ){
+        bool vgap;
+        return Next( aRaw, aGain, vgap );
+    }
+
+    inline uint32_t NumBadOps(){ return mNumBadOps; }
+
+private:
+
+    static inline int Unzigzag( const uint32_t acValue ){
+        return (int)( acValue >> 1 ) ^ -(int)( acValue & 1 );
+    }
+
+    bool ReadVarint( uint32_t& aValue ){
+        aValue = 0;
+        for ( int vshift = 0; vshift < 35; vshift += 7 ){
+            int vb = mSource.Read();
+            if ( vb < 0 ){
+                return false;
+            }
+            aValue |= (uint32_t)( vb & 0x7f ) << vshift;
+            if ( ( vb & 0x80 ) == 0 ){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // decodes one op, ticks become available through mRepeat/mHasSecond/mGapLen
+    bool ReadOp(){
+
+        int vop = mSource.Read();
+        if ( vop < 0 ){
+            return false;
+        }
+
+        if ( vop < 0x40 ){
+            // first tick now, the second one on the following Next()
+            mRaw += Unzigzag( ( vop >> 3 ) & 0x7 );
+            mRepeat = 1;
+            mSecondDelta = Unzigzag( vop & 0x7 );
+            mHasSecond = true;
+        }
+        else if ( vop < 0x80 ){
+            mRaw += Unzigzag( vop & 0x3f );
+            mRepeat = 1;
+        }
+        else if ( vop < 0xC0 ){
+            mRepeat = ( vop & 0x3f ) + 1;
+        }
+        else if ( vop == kTraceOpGain ){
+            int vg = mSource.Read();
+            if ( vg < 0 ){
+                return false;
+            }
+            mGain = vg;
+        }
+        else if ( vop == kTraceOpVarint ){
+            uint32_t vz;
+            if ( !ReadVarint( vz ) ){
+                return false;
+            }
+            mRaw += Unzigzag( vz );
+            mRepeat = 1;
+        }
+        else if ( vop == kTraceOpKeyframe ){
+            int vlo = mSource.Read();
+            int vhi = mSource.Read();
+            int vg = mSource.Read();
+            if ( vlo < 0 || vhi < 0 || vg < 0 ){
+                return false;
+            }
+            mRaw = vlo | ( vhi << 8 );
+            mGain = vg;
+        }
+        else if ( vop == kTraceOpGap ){
+            uint32_t vn;
+            if ( !ReadVarint( vn ) ){
+                return false;
+            }
+            mGapLen = vn;
+        }
+        else {
+            // unknown op, skip it and count
+            mNumBadOps++;
+        }
+        return true;
+    }
+
+private:
+    TSource& mSource;
+
+    int mRaw{0};
+    int mGain{0};
+
+    uint32_t mRepeat{0};
+    uint32_t mGapLen{0};
+    bool mHasSecond{false};
+    int mSecondDelta{0};
+
+    uint32_t mNumBadOps{0};
+};
@@ -0,0 +1,203 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// On-device light trace recorder
+//
+// encodes raw + gain per control tick (LightTraceCodec.hpp) into
+// RAM blocks; full blocks are written to SPIFFS by a low priority
+// task on core 0, so flash latency never reaches the audio loop.
+// If no block is free the ticks are dropped and logged as a gap.
+// Raw is kept within cLightTraceDeadBand of the reading, which keeps
+// sensor noise out of the file. Recording stops when the file reaches
+// cLightTraceMaxBytes.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "Arduino.h"
+#include <FS.h>
+#include <SPIFFS.h>
+#include "LarvaDefs.hpp"
+#include "LightTraceCodec.hpp"
+
+class LightTraceRecorder
+{
+public:
+    LightTraceRecorder() : mEncoder( cLightTraceDeadBand ) {}
+    ~LightTraceRecorder(){}
+
+    // callme @ setup, starts a new trace (replaces the previous one)
+    // false if the filesystem is not available
+    bool Init(){
+
+        if ( !SPIFFS.begin(true) ){
+            return false;
+        }
+
+        mFile = SPIFFS.open( cLightTracePath, FILE_WRITE );
+        if ( !mFile ){
+            return false;
+        }
+
+        uint8_t vheader[cLightTraceHeaderSize];
+        LightTraceWriteHeader( vheader, CONTROL_RATE );
+        mFile.write( vheader, cLightTraceHeaderSize );
+        mFileSize = cLightTraceHeaderSize;
+
+        mFreeQueue = xQueueCreate( cLightTraceNumBlocks, sizeof(int) );
+        mFullQueue = xQueueCreate( cLightTraceNumBlocks, sizeof(int) );
+        for ( int i = 0; i < cLightTraceNumBlocks; ++i ){
+            mBlockLen[i] = 0;
+            xQueueSend( mFreeQueue, &i, 0 );
+        }
+
+        mEncoder.Reset();
+        xTaskCreatePinnedToCore( WriterTask, "lighttrace", 4096, this, 1, NULL, 0 );
+        mRecording = true;
+        return true;
+    }
+
+    // callme @kr, with the reading and the gain it was scaled with
+    void Record( const int acRaw, const int acGain ){
+
+        if ( !mRecording ){
+            return;
+        }
+
+        if ( mCurBlock < 0 && xQueueReceive( mFreeQueue, &mCurBlock, 0 ) != pdTRUE ){
+            mCurBlock = -1;
+            mGapTicks++;
+            return;
+        }
+
+        uint8_t* vdst = mBlocks[mCurBlock] + mBlockLen[mCurBlock];
+        int vn = 0;
+        if ( mGapTicks > 0 ){
+            vn += mEncoder.EncodeGap( mGapTicks, vdst );
+            mGapTicks = 0;
+        }
+        vn += mEncoder.Encode( acRaw, acGain, vdst + vn );
+        mBlockLen[mCurBlock] += vn;
+
+        // keep room for a worst case tick + gap + final flush
+        if ( mBlockLen[mCurBlock] > cLightTraceBlockSize - 3 * cLightTraceMaxOpBytes ){
+            mBlockLen[mCurBlock] += mEncoder.Flush( mBlocks[mCurBlock] + mBlockLen[mCurBlock] );
+            xQueueSend( mFullQueue, &mCurBlock, 0 );
+            mCurBlock = -1;
+        }
+    }
+
+    inline bool Recording(){ return mRecording; }
+
+    // writes the stored trace to Serial, e.g. capture with
+    // cat /dev/ttyUSB0 > trace.klt (blocking, callme @ setup only)
+    static void DumpToSerial(){
+
+        if ( !SPIFFS.begin(true) ){
+            return;
+        }
+        File vfile = SPIFFS.open( cLightTracePath, FILE_READ );
+        if ( !vfile ){
+            return;
+        }
+
+        uint8_t vbuf[256];
+        int vn;
+        while ( ( vn = vfile.read( vbuf, sizeof(vbuf) ) ) > 0 ){
+            Serial.write( vbuf, vn );
+        }
+        Serial.flush();
+        vfile.close();
+    }
+
+private:
+
+    static void WriterTask( void* apRecorder ){
+
+        LightTraceRecorder* vrec = (LightTraceRecorder*)apRecorder;
+        int vblock;
+
+        for (;;){
+            xQueueReceive( vrec->mFullQueue, &vblock, portMAX_DELAY );
+
+            vrec->mFile.write( vrec->mBlocks[vblock], vrec->mBlockLen[vblock] );
+            vrec->mFile.flush();
+            vrec->mFileSize += vrec->mBlockLen[vblock];
+            vrec->mBlockLen[vblock] = 0;
+
+            if ( vrec->mFileSize + cLightTraceBlockSize > cLightTraceMaxBytes ){
+                vrec->mRecording = false;
+                vrec->mFile.close();
+                vTaskDelete(NULL);
+            }
+
+            xQueueSend( vrec->mFreeQueue, &vblock, 0 );
+        }
+    }
+
+private:
+    volatile bool mRecording{false};
+
+    LightTraceEncoder mEncoder;
+
+    uint8_t mBlocks[cLightTraceNumBlocks][cLightTraceBlockSize];
+    int mBlockLen[cLightTraceNumBlocks];
+    int mCurBlock{-1};
+    uint32_t mGapTicks{0};
+
+    QueueHandle_t mFreeQueue;
+    QueueHandle_t mFullQueue;
+
+    File mFile;
+    uint32_t mFileSize{0};
+};
+
+//---------------------------------------------------------
+// reads the stored trace back, byte source for ReplayLightSource
+class LightTraceFileSource
+{
+public:
+    LightTraceFileSource(){}
+    ~LightTraceFileSource(){}
+
+    // callme @ setup, false if there is no valid trace
+    bool Open(){
+        if ( !SPIFFS.begin(true) ){
+            return false;
+        }
+        mFile = SPIFFS.open( cLightTracePath, FILE_READ );
+        if ( !mFile ){
+            return false;
+        }
+        uint8_t vheader[cLightTraceHeaderSize];
+        if ( mFile.read( vheader, cLightTraceHeaderSize ) != cLightTraceHeaderSize ){
+            return false;
+        }
+        return LightTraceReadHeader( vheader ) == CONTROL_RATE;
+    }
+
+    // next byte, -1 at end
+    inline int Read(){
+        if ( mPos >= mLen ){
+            mLen = mFile ? mFile.read( mBuf, sizeof(mBuf) ) : 0;
+            mPos = 0;
+            if ( mLen <= 0 ){
+                return -1;
+            }
+        }
+        return mBuf[mPos++];
+    }
+
+private:
+    File mFile;
+    uint8_t mBuf[256];
+    int mLen{0};
+    int mPos{0};
+};
@@ -0,0 +1,55 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Load governor
+//
+// turns the measured load (LoadMeter, one value per control period)
+// into a shed level [0, cLoadShedMaxLevel] for LarvaSynth2::SetShedLevel.
+// Sheds fast (one level per tick above cLoadShedHigh), restores slowly
+// (one level per cLoadRestoreTicks below cLoadShedLow), so the level
+// does not oscillate around the threshold.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "LarvaDefs.hpp"
+
+class LoadGovernor
+{
+public:
+    LoadGovernor(){}
+    ~LoadGovernor(){}
+
+    // callme @kr, after LoadMeter::Update()
+    // returns the new shed level
+    inline int Update( const float acLoad ){
+
+        if ( acLoad > cLoadShedHigh ){
+            mCalmTicks = 0;
+            mLevel = mLevel < cLoadShedMaxLevel ? mLevel + 1 : mLevel;
+        }
+        else if ( acLoad < cLoadShedLow && mLevel > 0 ){
+            if ( ++mCalmTicks >= cLoadRestoreTicks ){
+                mCalmTicks = 0;
+                mLevel--;
+            }
+        }
+        else {
+            mCalmTicks = 0;
+        }
+        return mLevel;
+    }
+
+    inline int Level(){ return mLevel; }
+
+private:
+    int mLevel{0};
+    uint32_t mCalmTicks{0};
+};
@@ -0,0 +1,46 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// CPU load meter
+// busy time (Begin/End pairs) over wall time since last Update()
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "Profiler.hpp"
+
+class LoadMeter
+{
+public:
+    LoadMeter(){}
+    ~LoadMeter(){}
+
+    inline void Begin(){ mStart = ProfClock::Now(); }
+    inline void End(){ mBusy += ProfClock::Now() - mStart; }
+
+    // callme once per measuring period (e.g. @kr)
+    // returns busy fraction [0,1] over the elapsed period
+    inline float Update(){
+        uint32_t vnow = ProfClock::Now();
+        uint32_t velapsed = vnow - mPeriodStart;
+        mPeriodStart = vnow;
+        mLoad = velapsed > 0 ? (float)mBusy / (float)velapsed : 0.f;
+        mBusy = 0;
+        return mLoad;
+    }
+
+    inline float Load(){ return mLoad; }
+
+private:
+    uint32_t mStart{0};
+    uint32_t mBusy{0};
+    uint32_t mPeriodStart{0};
+    float mLoad{0.f};
+};
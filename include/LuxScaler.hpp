@@ -0,0 +1,92 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Raw light reading --> scaled light [0,1050]
+// no Arduino dependencies, shared with host tools
+//
+// LuxScale(): float reference
+// LuxScalerLUT: same mapping w/o transcendentals, default on device.
+// log(raw / (gain+1)) = log(raw) - log(gain+1), so two tables (raw, gain)
+// and an integer subtract. Checked against LuxScale() over all
+// raw/gain pairs by tools/LuxScalerCheck.cpp
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+// photosens out range
+static const float cLightRange = 1050.f; 
+
+// scaling & normalize according to Matteo Max Patch
+// DTR recalculated to: 
+// [0.0039, 4095] --> db [] (0.0039 = 1. / 256.)
+// [-48.18dB,+72.25dB] --> [0,1050]
+static const float cLuxDbMin = -48.18f;
+static const float cLuxDbMax = 72.25f;
+
+// raw [0,4095], gain [0,255]
+inline int LuxScale( const int acRaw, const int acGain ){
+
+    // correct raw lux reading w/ respect to gain
+    // from [0,4095] to [ 0.0039, 4095 ]
+    float vlux = (float)acRaw / (float)(acGain + 1.f);
+
+    float vluxdb = 20.f * log10( vlux );
+    vluxdb = vluxdb < cLuxDbMin ? cLuxDbMin : vluxdb > cLuxDbMax ? cLuxDbMax : vluxdb;
+    float vnorm = ( vluxdb - cLuxDbMin ) / ( cLuxDbMax - cLuxDbMin );
+    return (int)roundf( vnorm * cLightRange );
+}
+
+//---------------------------------------------------------
+static const int cLuxLutRawSize = 4096;
+static const int cLuxLutGainSize = 256;
+
+// table fixed point bits
+static const int cLuxLutShift = 14;
+
+class LuxScalerLUT
+{
+public:
+    LuxScalerLUT(){}
+    ~LuxScalerLUT(){}
+
+    // callme @ setup
+    // tables hold log10 already scaled to the output range,
+    // offset & rounding are folded into the gain table
+    void Init(){
+        const double vk = cLightRange * 20.0 / ( cLuxDbMax - cLuxDbMin );
+        const double voffset = -cLuxDbMin * cLightRange / ( cLuxDbMax - cLuxDbMin );
+        const double vone = (double)( 1L << cLuxLutShift );
+
+        // log(0) = -inf, always clamped to 0
+        mRawLog[0] = INT32_MIN / 2;
+        for ( int i = 1; i < cLuxLutRawSize; ++i ){
+            mRawLog[i] = (int32_t)lround( vk * log10( (double)i ) * vone );
+        }
+        for ( int i = 0; i < cLuxLutGainSize; ++i ){
+            mGainLog[i] = (int32_t)lround( ( vk * log10( i + 1.0 ) - voffset ) * vone )
+                        - ( 1L << ( cLuxLutShift - 1 ) );
+        }
+    }
+
+    // raw [0,4095], gain [0,255]
+    inline int Scale( const int acRaw, const int acGain ){
+        int vraw = acRaw < 0 ? 0 : acRaw >= cLuxLutRawSize ? cLuxLutRawSize - 1 : acRaw;
+        int vgain = acGain < 0 ? 0 : acGain >= cLuxLutGainSize ? cLuxLutGainSize - 1 : acGain;
+        int32_t vscaled = ( mRawLog[vraw] - mGainLog[vgain] ) >> cLuxLutShift;
+        return vscaled < 0 ? 0 : vscaled > (int32_t)cLightRange ? (int)cLightRange : (int)vscaled;
+    }
+
+private:
+    int32_t mRawLog[cLuxLutRawSize];
+    int32_t mGainLog[cLuxLutGainSize];
+};
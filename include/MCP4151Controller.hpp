@@ -24,13 +24,18 @@ public:
     MCP4151Controller(){}
     ~MCP4151Controller(){}
 
-    // init @ setup
+    // init @ setup, writes the current gain
     void Init(){
         pinMode(slaveSelectPin, OUTPUT); //??
+        digitalWrite(slaveSelectPin, HIGH);
         SPI.begin();
-        digitalPotWrite(0, 0); // initial value
+        mPendingPot = 255 - mGain;
+        digitalPotWrite(0, mPendingPot);
+        mWrittenPot = mPendingPot;
     }
 
+    // queues the new value, written by Flush()
+    // note: no bus traffic if the value does not change
     void SetGain( const int acGain ){
         int val = acGain;
         val = val>255 ? 255 : val;
@@ -38,8 +43,15 @@ public:
         mGain = val;
 
         // note: pot/gain is inverse
-        int pot = 255 - mGain;
-        digitalPotWrite(0, pot);
+        mPendingPot = 255 - mGain;
+    }
+
+    // callme @ loop, outside the audio and control callbacks
+    inline void Flush(){
+        if ( mPendingPot != mWrittenPot ){
+            digitalPotWrite(0, mPendingPot);
+            mWrittenPot = mPendingPot;
+        }
     }
 
     int GetGain(){ return mGain; }
@@ -47,6 +59,8 @@ public:
     // Write to digital pot to control photosensor amp
     void digitalPotWrite(int address, int value) 
     {
+        SPI.beginTransaction( SPISettings( cDigiPotSpiClock, MSBFIRST, SPI_MODE0 ) );
+
         // take the SS pin low to select the chip:
         digitalWrite(slaveSelectPin, LOW);
         
@@ -56,6 +70,8 @@ public:
         
         // take the SS pin high to de-select the chip:
         digitalWrite(slaveSelectPin, HIGH);
+
+        SPI.endTransaction();
     }
 
 private:
@@ -64,5 +80,7 @@ private:
     // 0...255
     int mGain{0};
 
-    unsigned long mPrevTimeStampMs{0};
+    // wiper value requested / last sent, -1 = unknown
+    int mPendingPot{-1};
+    int mWrittenPot{-1};
 };
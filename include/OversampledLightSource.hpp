@@ -0,0 +1,71 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Oversampled light source
+//
+// wraps a source read at sample rate (e.g. AdcLightSource), Sample()
+// is called by the acquisition side (sampling timer on device, a plain
+// loop on host) and feeds a LightDecimator. Read() @kr returns the
+// latest decimated value without touching the sensor.
+//
+// Sample() and Read() may run on different cores: the result is a
+// single aligned int, written once per control period.
+// No Arduino dependencies.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "LightSource.hpp"
+#include "LightDecimator.hpp"
+
+template <int TFastDecim, int TCtrlDecim>
+class OversampledLightSource : public LightSource
+{
+public:
+    typedef LightDecimator<TFastDecim, TCtrlDecim> Decimator;
+
+    OversampledLightSource( LightSource& aSensor ) : mSensor(aSensor) {}
+    virtual ~OversampledLightSource(){}
+
+    virtual void Init(){
+        mSensor.Init();
+        mDecimator.Reset();
+    }
+
+    // callme @ sample rate
+    inline void Sample(){
+
+        if ( mDecimator.Push( mSensor.Read() ) ){
+            mValue = mDecimator.Value();
+        }
+    }
+
+    // callme @kr, latest decimated reading
+    virtual int Read(){
+        return mValue;
+    }
+
+    // note: samples taken before the gain change are still in the
+    // decimator for Decimator::cNumTaps fast values (8 control periods)
+    virtual void SetGain( const int acGain ){
+        mGain = acGain;
+        mSensor.SetGain( acGain );
+    }
+
+    virtual void Flush(){
+        mSensor.Flush();
+    }
+
+private:
+    LightSource& mSensor;
+    Decimator mDecimator;
+
+    volatile int mValue{0};
+};
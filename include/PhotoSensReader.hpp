@@ -13,8 +13,11 @@
 
 #pragma once
 
-#include "MCP4151Controller.hpp"
 #include "LarvaDefs.hpp"
+#include "LightSource.hpp"
+#include "AdcLightSource.hpp"
+#include "Profiler.hpp"
+#include "LuxScaler.hpp"
 #include <RollingAverage.h>
 
 class PhotoSensReader
@@ -25,24 +28,31 @@ public:
     ~PhotoSensReader(){}
 
     // callme @ setup
-    void Init(){
-        pinMode( cPhotoSensPin, INPUT );
-        mDigiPot.Init();
-        mDigiPot.SetGain( mGain );
+    // reads from apSource if given, else from the photodiode
+    void Init( LightSource* apSource = NULL ){
+        mLuxLut.Init();
+        mpSource = apSource != NULL ? apSource : &mAdcSource;
+        mpSource->Init();
+        mpSource->SetGain( mGain );
     }
 
     // callback @ controlrate
-    void Update()
+    void Update( const uint32_t acTick )
     {
+        PROF_SCOPE(kProfSensor);
+
         // Get analog value
-        mLuxRaw = analogRead( cPhotoSensPin );
+        mLuxRaw = mpSource->Read();
         
         // note: avg keeps also out of range vals in order to check if calibration needed
         mLuxRawAvg = LuxMovAvg(mLuxRaw);
 
         // Calibrate the gain in order to keep the moving average in range
-        if ( mLuxRawAvg < mLuxRawAvgThresMin || mLuxRawAvg > mLuxRawAvgThresMax ){
-            Calibrate();
+        if ( cGainCalibMode == kGainCalibModel ){
+            CalibrateModel();
+        }
+        else if ( mLuxRawAvg < mLuxRawAvgThresMin || mLuxRawAvg > mLuxRawAvgThresMax ){
+            Calibrate( acTick );
         }
         else if (mCalibrating==true){
             mCalibrating=false;
@@ -65,20 +75,12 @@ public:
             mSaturated=false;
         }
         
-        // correct raw lux reading w/ respect to gain
-        // from [0,4095] to [ 0.0039, 4095 ]
-        float vlux = (float)mLuxRaw / (float)(mGain + 1.f);
-    
-        // scaling & normalize according to Matteo Max Patch
-        // DTR recalculated to: 
-        // [0.0039, 4095] --> db [] (0.0039 = 1. / 256.)
-        // [-48.18dB,+72.25dB] --> [0,1050]
-        float vluxdb = 20.f * log10( vlux );
-        float vdbmin = -48.18f;
-        float vdbmax = 72.25f;
-        vluxdb = limitf( vluxdb, vdbmin, vdbmax );
-        float vnorm = ( vluxdb - vdbmin ) / ( vdbmax - vdbmin );
-        mLuxScaled = (int)roundf( vnorm * cLightRange );
+        // gain corrected, log scaled to [0,1050]
+        #ifdef LUX_SCALE_FLOAT
+        mLuxScaled = LuxScale( mLuxRaw, mGain );
+        #else
+        mLuxScaled = mLuxLut.Scale( mLuxRaw, mGain );
+        #endif
 
         if (++mPrintCounter >= 20 ){
             mPrintCounter=0;
@@ -91,16 +93,15 @@ public:
     }
 
     // Gain Calibration
-    void Calibrate()
+    void Calibrate( const uint32_t acTick )
     {
         if ( mCalibrating==false ){
             mCalibrating = true;
         }
 
-        unsigned long now = millis();
-        if( now - mTimestamp > cGainModPeriodMs )
+        if( acTick - mGainTick >= cGainModPeriodTicks )
         {
-            mTimestamp = now;
+            mGainTick = acTick;
             int vdelta = mLuxRawAvg < mLuxRawAvgThresMin ? cGainStep : -cGainStep;
             mGain += vdelta;
             
@@ -113,28 +114,128 @@ public:
                 mCalibrating = false;
             }
 
-            mDigiPot.SetGain( mGain );   
+            mpSource->SetGain( mGain );   
+        }
+    }
+
+    // Model based gain calibration
+    // raw = lux * (gain+1), so from an unsaturated avg the gain that brings
+    // the input to cLuxRawTarget is computed directly. If the input clips
+    // the lux is unknown, and the gain is halved (binary search) instead.
+    // Every step narrows [mGainLo, mGainHi], thus it converges in <= 9 steps.
+    // Starts when the slow avg leaves [mLuxRawAvgThresMin, mLuxRawAvgThresMax]
+    // or is mostly clipped, once all of it was read at the current gain.
+    // Each step averages cGainCalibDwellTicks at the new gain, and the search 
+    // stops inside the narrower [cLuxRawStopMin, cLuxRawStopMax]: flicker
+    // around a steady avg does not move the gain.
+    void CalibrateModel()
+    {
+        mGainAge = mGainAge < cGainCalibAvgSize ? mGainAge + 1 : mGainAge;
+
+        if ( !mCalibrating ){
+            bool vclipHi = 2 * mNumClippedAvg >= cGainCalibAvgSize;
+            bool vinRange = mLuxRawAvg >= mLuxRawAvgThresMin && mLuxRawAvg <= mLuxRawAvgThresMax && !vclipHi;
+            if ( vinRange || mGainAge < cGainCalibAvgSize ){
+                return;
+            }
+            mCalibrating = true;
+            mGainLo = cGainMin;
+            mGainHi = cGainMax;
+            StepGainModel( mLuxRawAvg, vclipHi );
+            return;
+        }
+
+        // the first ticks after a change may be read before the pot is written
+        if ( mGainAge <= cGainCalibSettleTicks ){
+            return;
+        }
+        mDwellSum += mLuxRaw;
+        mDwellClipped += mLuxRaw > cLuxRawThresMax ? 1 : 0;
+        if ( ++mDwellCount < cGainCalibDwellTicks ){
+            return;
+        }
+
+        int vavg = mDwellSum / mDwellCount;
+        bool vclipHi = 2 * mDwellClipped >= mDwellCount;
+        if ( vavg >= cLuxRawStopMin && vavg <= cLuxRawStopMax && !vclipHi ){
+            EndGainModel();
+            return;
+        }
+        StepGainModel( vavg, vclipHi );
+    }
+
+    // one search step from the avg at the current gain
+    void StepGainModel( const int acAvg, const bool acClipHi )
+    {
+        // narrow the search range on the side we are leaving
+        int vgain;
+        if ( acClipHi ){
+            mGainHi = mGain - 1;
+            vgain = ( mGainLo + mGainHi ) / 2;
+        }
+        else if ( acAvg < cLuxRawThresMin ){
+            mGainLo = mGain + 1;
+            vgain = ( mGainLo + mGainHi + 1 ) / 2;
+        }
+        else {
+            vgain = ( cLuxRawTarget * ( mGain + 1 ) + acAvg / 2 ) / acAvg - 1;
+            if ( vgain > mGain ){
+                mGainLo = mGain + 1;
+            }
+            else if ( vgain < mGain ){
+                mGainHi = mGain - 1;
+            }
+        }
+
+        // reached limits or no better gain, that's the best we can do
+        if ( mGainLo > mGainHi || vgain == mGain ){
+            EndGainModel();
+            return;
         }
+
+        vgain = vgain < mGainLo ? mGainLo : ( vgain > mGainHi ? mGainHi : vgain );
+
+        mGain = vgain;
+        mpSource->SetGain( mGain );
+        mGainAge = 0;
+        mDwellSum = 0;
+        mDwellClipped = 0;
+        mDwellCount = 0;
+    }
+
+    // no restart until the slow avg is all at the current gain
+    inline void EndGainModel(){
+        mCalibrating = false;
+        mGainAge = 0;
+        mDwellSum = 0;
+        mDwellClipped = 0;
+        mDwellCount = 0;
+    }
+
+    // callme @ loop, outside audio & control callbacks
+    inline void Flush(){
+        mpSource->Flush();
     }
 
     inline float GetLuxScaled(){  return mLuxScaled; }
     inline float GetLuxRaw(){  return mLuxRaw; }
     inline bool Saturated(){ return mSaturated; }
+    inline bool Calibrating(){ return mCalibrating; }
+    inline int GetGain(){ return mGain; }
 
 private:
 
-    inline float limitf( const float aIn, const float aMin, const float aMax ){
-        float vOut = aIn < aMin ? aMin : aIn > aMax? aMax : aIn;
-        return vOut;
-    }
-
+    // also counts the clipped values in the window, see CalibrateModel()
     int LuxMovAvg(const int acval ){
         mAvgBuf[mAvgInd] = acval;
         mAvgInd = ++mAvgInd % cGainCalibAvgSize;
         int val=0;
+        int vnumClipped=0;
         for (int i=0; i<cGainCalibAvgSize; ++i){
             val+=mAvgBuf[i];
+            vnumClipped += mAvgBuf[i] > cLuxRawThresMax ? 1 : 0;
         }
+        mNumClippedAvg = vnumClipped;
         return val/cGainCalibAvgSize;
     }
     
@@ -149,6 +250,7 @@ private:
 
     // abs luma value in the range [0,1050]
     int mLuxScaled{0}; 
+    LuxScalerLUT mLuxLut;
     
     //---------------------------------------------------------
     // Gain Calibration
@@ -157,16 +259,26 @@ private:
 
     // slow movavg on raw input for gain calibration 
     int mLuxRawAvg{0}; 
-    int mAvgBuf[cGainCalibAvgSize];
+    int mAvgBuf[cGainCalibAvgSize]{};
     int mAvgInd{0};
+    int mNumClippedAvg{0};
 
     // current gain
     int mGain{0};
     
-    unsigned long mTimestamp{0};
+    uint32_t mGainTick{0};
+
+    // kGainCalibModel
+    int mGainAge{0}; // ticks since the last gain change, up to cGainCalibAvgSize
+    int mDwellSum{0};
+    int mDwellClipped{0};
+    int mDwellCount{0};
+    int mGainLo{cGainMin};
+    int mGainHi{cGainMax};
 
-    // Photodiode gain controller
-    MCP4151Controller mDigiPot;
+    // light input, photodiode by default
+    LightSource* mpSource{NULL};
+    AdcLightSource mAdcSource;
 
     // debug
     static const int cPrintCount = 1;
@@ -16,9 +16,36 @@
 #pragma once
 
 #include "LarvaDefs.hpp"
+#include "RandStream.hpp"
+#include "PlokResonator.hpp"
 #include <MozziGuts.h>
 #include <math.h>
 
+// resonator coefficient tables (+1 guard entry), linear interp
+// sin: cos(w) = 1 - 2 sin(w/2)^2 keeps the pitch error small at low freqs
+// vs expf/cosf: R within 2e-6, gain 0.2%, pitch 0.3 cents above 100Hz
+extern float mPlokSinTable[cPlokSinTableSize + 1];
+extern float mPlokExpTable[cPlokExpTableSize + 1];
+
+// callme @ setup
+void ComputePlokCoefTables();
+
+// shared excitation noise, [-1.5,1.5)
+// voices read their burst from a random offset, a block is renewed @kr
+extern float mPlokNoiseTable[cPlokNoiseTableSize];
+
+// callme @ setup, after the global seed is set
+void InitPlokNoise();
+
+// callme @kr
+void RefillPlokNoise();
+
+#ifdef PLOK_FIXED
+typedef PlokResonatorFixed PlokResonator;
+#else
+typedef PlokResonatorFloat PlokResonator;
+#endif
+
 class Plok{
 
 public:
@@ -39,32 +66,34 @@ public:
         UpdateBiquad();
         mCounter=0;
         mOnCounter=0;
+        mNoiseOffset = mRand.Next();
     }
 
     ~Plok(){}
+
+    // noise offset stream
+    inline void Seed( const uint32_t acStreamID ){ mRand.Seed( acStreamID ); }
     
-    inline float Process(){
+    // voice output, PlokResonator::ToFloat() converts
+    inline PlokResonator::Sample Process(){
 
         // update life counter
         if ( mOnCounter < mLifeEstimation ){
             mOnCounter++;
         }
-        
-        // white noise source
-        float vsig = WNoise() * 1.5f;
 
-        // envelope (simple rect impulse)
-        float venv = ++mCounter < mEnvDur ? 1.f : 0.f;
-        vsig *= venv;
+        // ringing: excitation over and out of the x history (x1 = x2 = 0),
+        // only the homogeneous part of the biquad is left
+        if ( mCounter > mEnvDur ){
+            return mRes.Ring();
+        }
+        
+        // excitation: white noise source, enveloped (simple rect impulse)
+        float vsig = ++mCounter < mEnvDur ? 
+                        mPlokNoiseTable[ ( mNoiseOffset + mCounter ) & ( cPlokNoiseTableSize - 1 ) ] : 0.f;
 
         // res biquad
-        float y0 = vsig * b0 + x2 * b2 + y1 * a1 + y2 * a2;
-        x2 = x1;
-        x1 = vsig;
-        y2 = y1;
-        y1 = y0;
-
-        return y0;
+        return mRes.Excite( vsig );
     }
 
     inline void SetImpulseDur(const int acValue){
@@ -85,6 +114,7 @@ public:
         mGain = acValue;
         b0 = R * mGain * ( 1.f -  R );
         b2 = -b0;
+        mRes.SetCoefs( b0, a1, a2 );
     }
     
     // one for all
@@ -103,25 +133,37 @@ private:
 
     void UpdateBiquad()
     {     
-        float bw = mFc / mQ;
-        R =  expf( -cOmegaFactor * bw  );
+        // w = 2pi fc / sr, R = exp( -w / Q )
+        float vw = cOmegaFactor * mFc;
+        vw = vw < PI ? vw : PI;
+        R = TableLookup( mPlokExpTable, cPlokExpTableSize, vw / mQ * cExpTableScale );
+        float vs = TableLookup( mPlokSinTable, cPlokSinTableSize, vw * cSinTableScale );
         
         // note signs - these are actually -a1, -a2
         a2 = -R * R;
-        a1 = 2.f * R * cosf( cOmegaFactor * mFc );
+        a1 = 2.f * R * ( 1.f - 2.f * vs * vs );
         b0 = R * mGain * ( 1.f -  R );
         b2 = -b0;
+        mRes.SetCoefs( b0, a1, a2 );
     }
-    
-    static constexpr __uint32_t rrandmax = 0x3fffffffu;
-    uint32_t rrand = 1u;
-    inline float WNoise(){
-        return (float)( (rrand = rrand * 1103515245u + 12345u) & rrandmax ) / 536870912.f - 1.f;
+
+    // acPos >= 0, clamped to the last cell (acSize, the guard): 
+    // reads stay within [0, acSize] at fc >= nyquist or Q < 1
+    static inline float TableLookup( const float* apTable, const int acSize, const float acPos ){
+        int vi = (int)acPos;
+        vi = vi < acSize ? vi : acSize - 1;
+        float vfrac = acPos - (float)vi;
+        vfrac = vfrac < 1.f ? vfrac : 1.f;
+        return apTable[vi] + vfrac * ( apTable[vi+1] - apTable[vi] );
     }
+    
+    RandStream mRand;
 
 private:
 
     static constexpr float cOmegaFactor = 2.f * PI / AUDIO_RATE;
+    static constexpr float cExpTableScale = cPlokExpTableSize / PI;
+    static constexpr float cSinTableScale = 0.5f * cPlokSinTableSize / ( 0.5f * PI );
     
     // life dur estim for 1 plok event
     unsigned long mLifeEstimation{0};
@@ -137,14 +179,14 @@ private:
     float a1{0.f};
     float a2{0.f};
     
-    float y2{0.f};
-    float y1{0.f};
-    float x1{0.f};
-    float x2{0.f};
+    PlokResonator mRes;
 
     // Envelope Gen
     int mCounter{0};
     int mEnvDur{25};
+
+    // burst start in mPlokNoiseTable
+    uint32_t mNoiseOffset{0};
 };
 
 //---------------------------------------------------------
@@ -155,6 +197,9 @@ public:
     PlokSynth(){}
     ~PlokSynth(){}
 
+    // seeds the voices noise, acID: owner string id
+    void Init( const int acID );
+
     void TriggerVoice(  const int acVoice, 
                         const float acFreq, 
                         const float acQ,
@@ -172,19 +217,31 @@ public:
 
     // sample rate callback
     inline float Process(){
+        #ifdef PLOK_FIXED
+        // voices are saturated to +-32 (2^25), 12 of them fit in 32 bits
+        int32_t vmix = 0;
+        #else
         float vmix = 0.f;
+        #endif
         for ( int i = 0; i < mNActiveVoices; ++i ){
             vmix += mpActiveVoices[i]->Process();    
         }
-        return vmix;
+        return PlokResonator::ToFloat( vmix );
+    }
+
+    // caps the voices available to Trigger(), ringing voices are not cut
+    inline void SetShedLevel( const int acLevel ){
+        mMaxVoices = acLevel < cNVoices ? cNVoices - acLevel : 1;
     }
 
-    inline bool Available(){ return (mNActiveVoices<cNVoices); }
+    inline bool Available(){ return (mNActiveVoices<mMaxVoices); }
+    inline int NumActiveVoices(){ return mNActiveVoices; }
 
 private:
     static const int cNVoices = 12;
     int mNActiveVoices{0};
+    int mMaxVoices{cNVoices};
     Plok mVoices[cNVoices];
-    Plok* mpActiveVoices[cNVoices];
+    Plok* mpActiveVoices[cNVoices]{};
     int mCurVoice{0};
 };
\ No newline at end of file
@@ -0,0 +1,210 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Plok resonator kernels
+//
+// biquad y0 = b0 (x0 - x2) + a1 y1 + a2 y2  (a1, a2 sign flipped)
+// Excite(): while there is input, Ring(): input & x history are 0
+//
+// PlokResonatorFloat: reference. A tiny constant is added to the
+//   recursion so the decaying tail settles at ~1e-12 instead of going
+//   subnormal (slow on x86). No effect on audible levels.
+// PlokResonatorFixed: 32 bit arithmetic only, Q20 output (+-32).
+//   16 bit coefficients in delta form (c1 = 2 - a1, c2 = 1 + a2) with
+//   a shift each: in the direct form (Q14 a1, a2) low ploks come out 
+//   with an error as large as their peak. Products are the high word
+//   of 32 x 32 (mulsh), the state is scaled up for quiet ploks and
+//   saturated. Vs float over the plok parameter range 
+//   (tools/PlokFixedCheck.cpp): worst -63.6dB below the voice peak,
+//   mean -83dB; the 16 bit coefficients alone give -63.7dB (a pole 
+//   detune below 0.05 cent, drifting over the 50ms life).
+// No Arduino dependencies.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+// anti-denormal offset, below float resolution for any signal > 1e-10
+static const float cPlokAntiDenormal = 1e-18f;
+
+class PlokResonatorFloat
+{
+public:
+    typedef float Sample;
+
+    static inline float ToFloat( const Sample acValue ){ return acValue; }
+
+    inline void SetCoefs( const float acB0, const float acA1, const float acA2 ){
+        b0 = acB0;
+        b2 = -acB0;
+        a1 = acA1;
+        a2 = acA2;
+    }
+
+    inline Sample Excite( const float acIn ){
+        float y0 = acIn * b0 + x2 * b2 + y1 * a1 + y2 * a2 + cPlokAntiDenormal;
+        x2 = x1;
+        x1 = acIn;
+        y2 = y1;
+        y1 = y0;
+        return y0;
+    }
+
+    inline Sample Ring(){
+        float y0 = y1 * a1 + y2 * a2 + cPlokAntiDenormal;
+        y2 = y1;
+        y1 = y0;
+        return y0;
+    }
+
+private:
+    float b0{0.f};
+    float b2{0.f};
+    float a1{0.f};
+    float a2{0.f};
+    
+    float y2{0.f};
+    float y1{0.f};
+    float x1{0.f};
+    float x2{0.f};
+};
+
+//---------------------------------------------------------
+class PlokResonatorFixed
+{
+public:
+    typedef int32_t Sample;
+
+    static const int cStateBits = 20;
+    static const int32_t cStateMax = ( 1L << 25 ) - 1; // 32 in Q20
+
+    static inline float ToFloat( const Sample acValue ){ 
+        return (float)acValue * ( 1.f / (float)( 1L << cStateBits ) ); 
+    }
+
+    // delta form: a1 = 2 - c1, a2 = c2 - 1. c1, c2 are exact in float
+    // for a1 in [1,2], a2 in [-1,-0.5]: the low ploks, where they are tiny
+    inline void SetCoefs( const float acB0, const float acA1, const float acA2 ){
+        SetHeadroom( acB0 );
+        mB0 = ToCoef( ldexpf( acB0, mK ), cInPreShift, mB0Shift );
+        mC1 = ToCoef( 2.f - acA1, cStatePreShift, mC1Shift );
+        mC2 = ToCoef( 1.f + acA2, cStatePreShift, mC2Shift );
+    }
+
+    inline Sample Excite( const float acIn ){
+        int32_t vx = (int32_t)( acIn * (float)( 1L << cStateBits ) );
+        int32_t vacc = Recursion() + Mul( ( vx - mX2 ) * ( 1 << cInPreShift ), mB0, mB0Shift );
+        mX2 = mX1;
+        mX1 = vx;
+        return Store( vacc );
+    }
+
+    inline Sample Ring(){
+        return Store( Recursion() );
+    }
+
+private:
+    // the state runs mK bits above the output, so quiet (low, high Q) 
+    // ploks use the whole state range: peak <= ~45 b0 (noise burst) 
+    // stays below 23 in state units
+    inline void SetHeadroom( const float acB0 ){
+        int vexp;
+        frexpf( acB0, &vexp );
+        int vk = -vexp - 1;
+        vk = vk < 0 ? 0 : vk > 12 ? 12 : vk;
+        if ( vk == mK ){
+            return;
+        }
+        // live voice: rescale the state
+        int vd = vk - mK;
+        mY1 = Saturate( vd > 0 ? (int64_t)mY1 * ( 1 << vd ) : mY1 >> -vd );
+        mY2 = Saturate( vd > 0 ? (int64_t)mY2 * ( 1 << vd ) : mY2 >> -vd );
+        mErr1 = mErr2 = 0;
+        mK = vk;
+    }
+
+    // accumulator: state + cFracBits, for the error feedback
+    static const int cFracBits = 2;
+    // operands are shifted up before the high word multiply, 
+    // state < 2^25, input < 2^22
+    static const int cStatePreShift = 5;
+    static const int cInPreShift = 8;
+    static const int cMantBits = 15;
+
+    // acValue ~ m 2^-(cMantBits + e), |m| < 2^15, e as large as fits:
+    // 16 bit precision relative to the coefficient, also for the tiny
+    // c1, c2 of low, high Q ploks. Returns m in the high half word, 
+    // aShift scales Mul() to the accumulator
+    static inline int32_t ToCoef( const float acValue, const int acPreShift, int& aShift ){
+        int vexp;
+        frexpf( acValue, &vexp );
+        int ve = -vexp;
+        // shift range [0,30]
+        const int vemin = cFracBits + 1 - acPreShift;
+        const int vemax = 30 + vemin;
+        ve = ve < vemin ? vemin : ve > vemax ? vemax : ve;
+        long vm = lroundf( ldexpf( acValue, cMantBits + ve ) );
+        vm = vm > 32767 ? 32767 : vm < -32767 ? -32767 : vm;
+        aShift = ve - vemin;
+        return (int32_t)( vm * 65536L );
+    }
+
+    // high word of the 32 x 32 product (one mulsh on the ESP32), rounded shift
+    static inline int32_t Mul( const int32_t acValue, const int32_t acCoef, const int acShift ){
+        int32_t vp = (int32_t)( ( (int64_t)acValue * acCoef ) >> 32 );
+        return ( vp + ( ( 1 << acShift ) >> 1 ) ) >> acShift;
+    }
+
+    static inline int32_t Saturate( const int64_t acValue ){
+        return (int32_t)( acValue > cStateMax ? cStateMax : acValue < -cStateMax ? -cStateMax : acValue );
+    }
+
+    // a1 y1 + a2 y2 = 2 y1 - y2 - c1 y1 + c2 y2, in accumulator units
+    inline int32_t Recursion(){
+        return ( 2 * mY1 - mY2 ) * ( 1 << cFracBits )
+             - Mul( mY1 * ( 1 << cStatePreShift ), mC1, mC1Shift ) 
+             + Mul( mY2 * ( 1 << cStatePreShift ), mC2, mC2Shift );
+    }
+
+    // rounding with 2nd order error feedback (1 - z^-1)^2: pushes the
+    // rounding noise away from DC, where low ploks would amplify it most
+    inline Sample Store( const int32_t acAcc ){
+        int32_t vacc = acAcc + 2 * mErr1 - mErr2;
+        int32_t vy = ( vacc + ( 1 << ( cFracBits - 1 ) ) ) >> cFracBits;
+        int32_t verr = vacc - vy * ( 1 << cFracBits );
+        if ( vy > cStateMax || vy < -cStateMax ){
+            vy = Saturate( vy );
+            verr = 0;
+        }
+        mErr2 = mErr1;
+        mErr1 = verr;
+        mY2 = mY1;
+        mY1 = vy;
+        return ( vy + ( ( 1 << mK ) >> 1 ) ) >> mK;
+    }
+
+private:
+    int32_t mB0{0};
+    int32_t mC1{0};
+    int32_t mC2{0};
+    int mB0Shift{0};
+    int mC1Shift{0};
+    int mC2Shift{0};
+    int mK{0};
+
+    int32_t mY2{0};
+    int32_t mY1{0};
+    int32_t mX1{0};
+    int32_t mX2{0};
+    int32_t mErr1{0};
+    int32_t mErr2{0};
+};
@@ -0,0 +1,141 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Scoped section profiler
+//
+// enable with #define PROFILE (see LarvaDefs.hpp), otherwise
+// PROF_SCOPE() compiles to nothing.
+// Timing source: cycle counter on ESP32, micros() on other
+// Arduino targets, std::chrono on host builds.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ARDUINO)
+#include "Arduino.h"
+#else
+#include <chrono>
+#endif
+
+// profiled sections
+// note: sections can be nested, e.g. kProfRetune is also part of kProfChordUpdate
+enum ProfSection {
+    kProfSensor=0,      // PhotoSensReader::Update
+    kProfSynthUpdate,   // LarvaSynth2::Update, whole control tick
+    kProfChordUpdate,   // LarvaChord::Update
+    kProfRetune,        // LarvaString::Retune
+    kProfPlokTrigger,   // LarvaString::TriggerRandomPulse
+    kProfAudio,         // LarvaSynth2::Process, one sample
+
+    kNumProfSections
+};
+
+// histogram bins, x4 steps: <1, <4, <16, <64, <256, <1024, <4096, >=4096 us
+static const int cProfHistBins = 8;
+
+//---------------------------------------------------------
+// timing source
+namespace ProfClock {
+
+#if defined(ESP32)
+    static const uint32_t cTicksPerUs = F_CPU / 1000000;
+
+    inline uint32_t Now(){
+        uint32_t vccount;
+        __asm__ __volatile__("rsr %0, ccount" : "=a"(vccount));
+        return vccount;
+    }
+#elif defined(ARDUINO)
+    static const uint32_t cTicksPerUs = 1;
+
+    inline uint32_t Now(){ return micros(); }
+#else
+    static const uint32_t cTicksPerUs = 1000;
+
+    inline uint32_t Now(){
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+#endif
+
+    inline float TicksToUs( const uint32_t acTicks ){
+        return (float)acTicks / (float)cTicksPerUs;
+    }
+}
+
+//---------------------------------------------------------
+// per section stats, fixed memory
+struct ProfStats
+{
+    uint32_t count;
+    uint32_t min;   // ticks
+    uint32_t max;   // ticks
+    uint64_t sum;   // ticks
+    uint32_t hist[cProfHistBins];
+};
+
+class Profiler
+{
+public:
+
+    static inline void Add( const ProfSection acSection, const uint32_t acTicks ){
+
+        ProfStats& vs = mStats[acSection];
+        vs.min = ( vs.count==0 || acTicks < vs.min ) ? acTicks : vs.min;
+        vs.count++;
+        vs.sum += acTicks;
+        vs.max = acTicks > vs.max ? acTicks : vs.max;
+
+        // bin index = ceil( bitlength(us) / 2 ), i.e. x4 steps
+        uint32_t vus = acTicks / ProfClock::cTicksPerUs;
+        int vbits = vus > 0 ? 32 - __builtin_clz(vus) : 0;
+        int vbin = ( vbits + 1 ) >> 1;
+        vs.hist[ vbin < cProfHistBins ? vbin : cProfHistBins - 1 ]++;
+    }
+
+    static void Reset();
+
+    // prints a min/mean/max/histogram table (Serial on device, stdout on host)
+    static void Print();
+
+    static inline const ProfStats& Stats( const ProfSection acSection ){
+        return mStats[acSection];
+    }
+
+    static const char* Name( const ProfSection acSection );
+
+private:
+    static ProfStats mStats[kNumProfSections];
+};
+
+//---------------------------------------------------------
+// RAII helper, measures the enclosing scope
+class ProfScope
+{
+public:
+    explicit ProfScope( const ProfSection acSection )
+        : mSection(acSection), mStart(ProfClock::Now()) {}
+
+    ~ProfScope(){
+        Profiler::Add( mSection, ProfClock::Now() - mStart );
+    }
+
+private:
+    ProfSection mSection;
+    uint32_t mStart;
+};
+
+#ifdef PROFILE
+#define PROF_SCOPE(section) ProfScope vProfScope_##section(section)
+#else
+#define PROF_SCOPE(section)
+#endif
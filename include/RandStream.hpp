@@ -0,0 +1,85 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Random streams
+//
+// xorshift32 generator, one independent stream per chord/string/voice.
+// Each stream is seeded from the global seed and its own stream id,
+// so a given global seed reproduces the whole device.
+// No Arduino dependencies.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+
+// global seed, set once @ setup before the streams are seeded
+inline uint32_t& RandGlobalSeed(){
+    static uint32_t vseed = 1;
+    return vseed;
+}
+
+inline void RandSetGlobalSeed( const uint32_t acSeed ){
+    RandGlobalSeed() = acSeed;
+}
+
+// seed for stream acStreamID (murmur3 finalizer on seed & id), never 0
+inline uint32_t RandStreamSeed( const uint32_t acStreamID ){
+    uint32_t vh = RandGlobalSeed() ^ ( acStreamID * 0x9e3779b9u );
+    vh ^= vh >> 16;
+    vh *= 0x85ebca6bu;
+    vh ^= vh >> 13;
+    vh *= 0xc2b2ae35u;
+    vh ^= vh >> 16;
+    return vh != 0 ? vh : 0x6d2b79f5u;
+}
+
+//---------------------------------------------------------
+class RandStream
+{
+public:
+    RandStream(){}
+    ~RandStream(){}
+
+    inline void Seed( const uint32_t acStreamID ){
+        mState = RandStreamSeed( acStreamID );
+    }
+
+    inline uint32_t Next(){
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        return mState;
+    }
+
+    // [0, acRange), multiply-shift instead of modulo
+    inline uint32_t Range( const uint32_t acRange ){
+        return (uint32_t)( ( (uint64_t)Next() * acRange ) >> 32 );
+    }
+
+    // [0,1)
+    inline float Uniform(){
+        return (float)( Next() >> 8 ) * ( 1.f / 16777216.f );
+    }
+
+    // [-1,1)
+    inline float Bipolar(){
+        return (float)(int32_t)Next() * ( 1.f / 2147483648.f );
+    }
+
+private:
+    uint32_t mState{0x6d2b79f5u};
+};
+
+// stream ids
+static const uint32_t cRandStreamChord = 0x10000;  // + chord id
+static const uint32_t cRandStreamString = 0x20000; // + string id
+static const uint32_t cRandStreamPlok = 0x30000;   // + string id * 16 + voice
+static const uint32_t cRandStreamNoise = 0x40000;  // shared plok noise
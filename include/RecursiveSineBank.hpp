@@ -0,0 +1,117 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Recursive sine oscillator bank (DRONE_RECURSIVE, see LarvaString)
+//
+// magic circle oscillators, no table reads:
+//   x -= e * y;  y += e * x;    e = 2 sin( pi f / fs )
+// stable for any e < 2, frequency changes (lfo) only touch e.
+// x^2 + y^2 - e x y is invariant, the output y peaks at
+// sqrt( invariant / ( 1 - e^2/4 ) ): it is rescaled to the target
+// when e moves (exact) and @kr with one Newton step of 1/sqrt,
+// against float rounding drift.
+// Output in the units of the int8 sine tables (amplitude 127) x 8 bit gain.
+// No Arduino dependencies, see tools/DroneEngineBench.cpp
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+static const float cRecursiveSineAmp = 127.f;
+
+template <int TNumPartials>
+class RecursiveSineBank
+{
+public:
+    RecursiveSineBank(){}
+    ~RecursiveSineBank(){}
+
+    // callme @ setup, all partials at phase 0 as Oscil
+    void Init( const float acSampleRate ){
+        mPiOverRate = (float)M_PI / acSampleRate;
+        for ( int i = 0; i < TNumPartials; ++i ){
+            mX[i] = cRecursiveSineAmp;
+            mY[i] = 0.f;
+            mE[i] = 0.f;
+            mTarget[i] = cRecursiveSineAmp * cRecursiveSineAmp;
+            mGains[i] = 0.f;
+        }
+    }
+
+    // callme when the partial freqs change (retune, lfo)
+    void SetFreqs( const float* apFreqs ){
+        for ( int i = 0; i < TNumPartials; ++i ){
+            float vhalfw = apFreqs[i] * mPiOverRate;
+            float vs = sinf( vhalfw );
+            mE[i] = 2.f * vs;
+            // invariant giving a peak of cRecursiveSineAmp on y
+            mTarget[i] = cRecursiveSineAmp * cRecursiveSineAmp * ( 1.f - vs * vs );
+
+            float vscale = sqrtf( mTarget[i] / Invariant(i) );
+            mX[i] *= vscale;
+            mY[i] *= vscale;
+        }
+    }
+
+    // callme @kr, partial gains [0,255], also renormalizes
+    void SetGains( const uint8_t* apGains ){
+        for ( int i = 0; i < TNumPartials; ++i ){
+            mGains[i] = (float)apGains[i];
+
+            float vscale = 1.5f - 0.5f * Invariant(i) / mTarget[i];
+            mX[i] *= vscale;
+            mY[i] *= vscale;
+        }
+    }
+
+    // callme @sr
+    inline float Next(){
+        float vsum = 0.f;
+        for ( int i = 0; i < TNumPartials; ++i ){
+            mX[i] -= mE[i] * mY[i];
+            mY[i] += mE[i] * mX[i];
+            vsum += mY[i] * mGains[i];
+        }
+        return vsum;
+    }
+
+    // callme @sr, only the partials listed in apPartials (load shedding),
+    // the others hold their state. The full list takes the unrolled loop
+    inline float Next( const int* apPartials, const int acNumPartials ){
+        if ( acNumPartials == TNumPartials ){
+            return Next();
+        }
+        float vsum = 0.f;
+        for ( int n = 0; n < acNumPartials; ++n ){
+            const int i = apPartials[n];
+            mX[i] -= mE[i] * mY[i];
+            mY[i] += mE[i] * mX[i];
+            vsum += mY[i] * mGains[i];
+        }
+        return vsum;
+    }
+
+private:
+
+    inline float Invariant( const int i ){
+        return mX[i] * mX[i] + mY[i] * mY[i] - mE[i] * mX[i] * mY[i];
+    }
+
+private:
+    float mPiOverRate{0.f};
+
+    float mX[TNumPartials];
+    float mY[TNumPartials];
+    float mE[TNumPartials];
+    float mTarget[TNumPartials];
+    float mGains[TNumPartials];
+};
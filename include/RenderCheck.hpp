@@ -0,0 +1,23 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Golden render regression check
+//
+// renders the canonical light traces (RenderHash.hpp) through a fresh,
+// fixed-seed LarvaSynth2, faster than real time and without audio output,
+// hashes the int16 output per block and compares against GoldenHashes.hpp.
+// Reports the first divergent block of each trace on Serial.
+// Runs on the host too, see tools/RenderCheckHost.cpp.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+// returns the num of traces that diverged from their golden hashes
+int RunRenderCheck();
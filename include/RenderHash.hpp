@@ -0,0 +1,98 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Golden render helpers
+//
+// - per block FNV-1a hash of the int16 output stream
+// - canonical light traces (integer only, fully reproducible)
+// No Arduino dependencies.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+
+// hashed block length (samples), 1/4 s @ 32768 Hz
+static const int cRenderHashBlockSize = 8192;
+
+class RenderHasher
+{
+public:
+    RenderHasher(){}
+    ~RenderHasher(){}
+
+    inline void Reset(){
+        mHash = cFnvOffset;
+        mCount = 0;
+    }
+
+    // returns true when a block is complete, see LastHash()
+    inline bool Push( const int16_t acSample ){
+        mHash = ( mHash ^ (uint8_t)( acSample ) ) * cFnvPrime;
+        mHash = ( mHash ^ (uint8_t)( acSample >> 8 ) ) * cFnvPrime;
+        if ( ++mCount < cRenderHashBlockSize ){
+            return false;
+        }
+        mLastHash = mHash;
+        Reset();
+        return true;
+    }
+
+    inline uint32_t LastHash(){ return mLastHash; }
+
+private:
+    static const uint32_t cFnvOffset = 2166136261u;
+    static const uint32_t cFnvPrime = 16777619u;
+
+    uint32_t mHash{cFnvOffset};
+    uint32_t mLastHash{0};
+    int mCount{0};
+};
+
+//---------------------------------------------------------
+// canonical light traces, one (raw, gain) pair per control tick
+
+enum RenderTraceID {
+    kTraceSweep=0,  // raw 1->4095 @ low gain, then again @ high gain: crosses all chord ranges
+    kTraceFlicker,  // 4Hz leaf flicker over a slow drift: dense triggers & ploks
+    kTraceSteps,    // 5 held levels, 12s each: chord changes & drone decay
+
+    kNumRenderTraces
+};
+
+static const int cRenderTraceTicks = 60 * 64; // 60s @ 64Hz
+
+inline void RenderTrace( const int acTrace, const int acTick, int& aRaw, int& aGain ){
+
+    const int vhalf = cRenderTraceTicks / 2;
+
+    switch ( acTrace ){
+        case kTraceSweep:
+            aGain = acTick < vhalf ? 255 : 0;
+            aRaw = 1 + ( ( acTick % vhalf ) * 4094 ) / ( vhalf - 1 );
+            break;
+
+        case kTraceFlicker: {
+            int vdrift = ( acTick * 1000 ) / cRenderTraceTicks;
+            int vflick = ( ( acTick / 8 ) & 1 ) ? 600 : -600;
+            aGain = 32;
+            aRaw = 1500 + vdrift + vflick;
+            break;
+        }
+
+        case kTraceSteps:
+        default: {
+            static const int cLevels[5] = { 40, 400, 1200, 2500, 4000 };
+            aGain = 16;
+            aRaw = cLevels[ ( acTick * 5 ) / cRenderTraceTicks ];
+            break;
+        }
+    }
+}
@@ -0,0 +1,170 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Parametric light generators
+//
+// reproducible inputs for benchmarks, load tests and offline renders.
+// Light levels in raw counts @ gain 0 (see ModelLightSource),
+// e.g. 2000 = mid ADC range at minimum gain, 10 = dim room.
+// No Arduino dependencies.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "LightSource.hpp"
+
+//---------------------------------------------------------
+// clouds passing in front of the sun: raised cosine dips of random
+// depth & duration, separated by random clear gaps
+class CloudLightSource : public ModelLightSource
+{
+public:
+    // acMeanSecs: mean duration of clouds and of the gaps between them
+    CloudLightSource( const float acLux, const float acMaxDepth, const float acMeanSecs, 
+                      const uint32_t acSeed, const int acControlRate = 64 )
+        : mLux(acLux), mMaxDepth(acMaxDepth), 
+          mMeanTicks( acMeanSecs * acControlRate ), mRand( acSeed ? acSeed : 1u ) 
+    {
+        mGapTicks = RandTicks();
+    }
+    virtual ~CloudLightSource(){}
+
+protected:
+    virtual float NextLux(){
+
+        if ( mGapTicks > 0 ){
+            mGapTicks--;
+            if ( mGapTicks == 0 ){
+                mCloudTicks = RandTicks();
+                mCloudPos = 0;
+                mDepth = mMaxDepth * ( 0.25f + 0.75f * Rand01() );
+            }
+            return mLux;
+        }
+
+        float vphase = (float)mCloudPos / (float)mCloudTicks;
+        float vdip = 0.5f * ( 1.f - cosf( 6.2831853f * vphase ) ) * mDepth;
+        if ( ++mCloudPos >= mCloudTicks ){
+            mGapTicks = RandTicks();
+        }
+        return mLux * ( 1.f - vdip );
+    }
+
+private:
+    inline float Rand01(){
+        mRand = mRand * 1103515245u + 12345u;
+        return (float)( mRand >> 8 ) / 16777216.f;
+    }
+
+    // [0.5, 1.5] x mean, at least 1 tick
+    inline int RandTicks(){
+        int vticks = (int)( mMeanTicks * ( 0.5f + Rand01() ) );
+        return vticks > 1 ? vticks : 1;
+    }
+
+    float mLux;
+    float mMaxDepth;
+    float mMeanTicks;
+    uint32_t mRand;
+
+    int mGapTicks{0};
+    int mCloudTicks{1};
+    int mCloudPos{0};
+    float mDepth{0.f};
+};
+
+//---------------------------------------------------------
+// leaves flickering in the sun: square wave between lux and lux * (1 - depth).
+// Rates near or above half the control rate alias, as on the real sensor;
+// a rate of a quarter of the control rate with full depth maximises plok triggers
+class FlickerLightSource : public ModelLightSource
+{
+public:
+    FlickerLightSource( const float acLux, const float acDepth, const float acRateHz, 
+                        const int acControlRate = 64 )
+        : mLux(acLux), mDepth(acDepth), mPhaseInc( acRateHz / acControlRate ) {}
+    virtual ~FlickerLightSource(){}
+
+protected:
+    virtual float NextLux(){
+        float vout = mPhase < 0.5f ? mLux : mLux * ( 1.f - mDepth );
+        mPhase += mPhaseInc;
+        mPhase -= floorf( mPhase );
+        return vout;
+    }
+
+private:
+    float mLux;
+    float mDepth;
+    float mPhaseInc;
+    float mPhase{0.f};
+};
+
+//---------------------------------------------------------
+// sequence of held levels, loops
+class StepLightSource : public ModelLightSource
+{
+public:
+    static const int cMaxLevels = 8;
+
+    StepLightSource( const float* apLevels, const int acNumLevels, const float acHoldSecs, 
+                     const int acControlRate = 64 )
+        : mHoldTicks( (int)( acHoldSecs * acControlRate ) )
+    {
+        SetLevels( apLevels, acNumLevels );
+        mHoldTicks = mHoldTicks > 1 ? mHoldTicks : 1;
+    }
+    virtual ~StepLightSource(){}
+
+protected:
+    void SetLevels( const float* apLevels, const int acNumLevels ){
+        mNumLevels = acNumLevels < cMaxLevels ? acNumLevels : cMaxLevels;
+        mNumLevels = mNumLevels > 0 ? mNumLevels : 1;
+        for ( int i = 0; i < mNumLevels; ++i ){
+            mLevels[i] = ( apLevels != NULL && acNumLevels > 0 ) ? apLevels[i] : 0.f;
+        }
+        mCurLevel = 0;
+        mTicks = 0;
+    }
+
+    virtual float NextLux(){
+        float vout = mLevels[mCurLevel];
+        if ( ++mTicks >= mHoldTicks ){
+            mTicks = 0;
+            mCurLevel = ( mCurLevel + 1 ) % mNumLevels;
+        }
+        return vout;
+    }
+
+private:
+    float mLevels[cMaxLevels];
+    int mNumLevels;
+    int mHoldTicks;
+    int mTicks{0};
+    int mCurLevel{0};
+};
+
+//---------------------------------------------------------
+// normal light interrupted by levels out of the sensor range:
+// too bright even at minimum gain (raw stuck at 4095), then total darkness (raw 0)
+class SaturationLightSource : public StepLightSource
+{
+public:
+    SaturationLightSource( const float acLux, const float acHoldSecs, const int acControlRate = 64 )
+        : StepLightSource( NULL, 0, acHoldSecs, acControlRate ) 
+    {
+        const float vlevels[4] = { acLux, 10.f * cLightSourceRawMax, acLux, 0.f };
+        SetLevels( vlevels, 4 );
+    }
+    virtual ~SaturationLightSource(){}
+};
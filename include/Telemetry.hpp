@@ -0,0 +1,88 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Binary telemetry channel
+//
+// records are framed (TelemetryRecord.hpp) into a ring buffer @kr
+// and drained to Serial without blocking from loop().
+// When the buffer is full new frames are dropped (and counted),
+// the receiver sees it as a gap in the sequence numbers.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include "Arduino.h"
+#include "LarvaDefs.hpp"
+#include "TelemetryRecord.hpp"
+
+class Telemetry
+{
+public:
+    Telemetry(){}
+    ~Telemetry(){}
+
+    // callme @ setup
+    void Init(){
+        Serial.begin(cTelemetryBaud);
+    }
+
+    // callme @kr
+    void Push( TelemetryRecord& aRec ){
+
+        aRec.seq = mSeq++;
+
+        if ( cTelemetryBufSize - ( mHead - mTail ) < (unsigned)cTelemFrameSize ){
+            mNumDropped++;
+            return;
+        }
+
+        uint8_t vframe[cTelemFrameSize];
+        TelemEncode( aRec, vframe );
+        for ( int i = 0; i < cTelemFrameSize; ++i ){
+            mBuf[ mHead++ & cTelemetryBufMask ] = vframe[i];
+        }
+    }
+
+    // callme from loop(), writes only what the uart can take right now
+    void Drain(){
+
+        unsigned vpending = mHead - mTail;
+        if ( vpending == 0 ){
+            return;
+        }
+
+        unsigned vfree = (unsigned)Serial.availableForWrite();
+        unsigned vn = vpending < vfree ? vpending : vfree;
+
+        // contiguous chunk up to the end of the ring
+        unsigned vpos = mTail & cTelemetryBufMask;
+        unsigned vchunk = cTelemetryBufSize - vpos;
+        vn = vn < vchunk ? vn : vchunk;
+
+        if ( vn > 0 ){
+            Serial.write( &mBuf[vpos], vn );
+            mTail += vn;
+        }
+    }
+
+    inline uint32_t NumDropped(){ return mNumDropped; }
+
+private:
+    static const unsigned cTelemetryBufMask = cTelemetryBufSize - 1;
+
+    uint8_t mBuf[cTelemetryBufSize];
+
+    // free running indexes, masked on access
+    unsigned mHead{0};
+    unsigned mTail{0};
+
+    uint8_t mSeq{0};
+    uint32_t mNumDropped{0};
+};
@@ -0,0 +1,205 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Telemetry record format
+//
+// fixed size binary frame, little endian, shared by the firmware
+// (Telemetry.hpp) and the host decoder (tools/TelemetryDecode.cpp).
+// No Arduino dependencies.
+//
+//  off size field
+//   0   2   sync 0xA5 0x5A
+//   2   1   format version
+//   3   1   sequence number (wraps), gaps = dropped frames
+//   4   4   timestamp (ms)
+//   8   2   light raw [0,4095]
+//  10   2   light scaled [0,1050]
+//  12   1   digipot gain [0,255]
+//  13   1   flags (kTelemSaturated, kTelemCalibrating)
+//  14   2   delta scaler x1000
+//  16   2   triggers avg (triggers / interval)
+//  18   2   pulse master gain x1000
+//  20   2   pulse resonance x100
+//  22   1   active chords
+//  23   1   active strings
+//  24   1   active (non silent) partials
+//  25   1   active plok voices
+//  26   2   cpu load, permille
+//  28   1   load shed level (LoadGovernor.hpp), 0 = full synthesis
+//  29   2   clipped output samples in the interval (saturating)
+//  31   2   output peak before saturation, permille of full scale
+//  33   1   crc8 of bytes [0,32]
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+
+static const uint8_t cTelemSync0 = 0xA5;
+static const uint8_t cTelemSync1 = 0x5A;
+static const uint8_t cTelemVersion = 2;
+static const int cTelemFrameSize = 34;
+
+enum TelemFlags {
+    kTelemSaturated = 0x01,
+    kTelemCalibrating = 0x02,
+};
+
+struct TelemetryRecord
+{
+    uint8_t seq;
+    uint32_t timeMs;    // audio clock, samples rendered * 1000 / AUDIO_RATE
+    uint16_t luxRaw;
+    uint16_t luxScaled;
+    uint8_t gain;
+    uint8_t flags;
+    uint16_t deltaScaler;   // x1000
+    uint16_t triggersAvg;
+    uint16_t pulseGain;     // x1000
+    uint16_t pulseRes;      // x100
+    uint8_t numChords;
+    uint8_t numStrings;
+    uint8_t numPartials;
+    uint8_t numPloks;
+    uint16_t cpuLoad;       // permille
+    uint8_t shedLevel;
+    uint16_t clips;
+    uint16_t peak;          // permille, > 1000 = clipped
+};
+
+// CRC-8, poly 0x07
+inline uint8_t TelemCrc8( const uint8_t* apData, const int acLen ){
+    uint8_t vcrc = 0;
+    for ( int i = 0; i < acLen; ++i ){
+        vcrc ^= apData[i];
+        for ( int b = 0; b < 8; ++b ){
+            vcrc = ( vcrc & 0x80 ) ? (uint8_t)( ( vcrc << 1 ) ^ 0x07 ) : (uint8_t)( vcrc << 1 );
+        }
+    }
+    return vcrc;
+}
+
+inline void TelemPut16( uint8_t* apDst, const uint16_t acValue ){
+    apDst[0] = (uint8_t)( acValue );
+    apDst[1] = (uint8_t)( acValue >> 8 );
+}
+
+inline uint16_t TelemGet16( const uint8_t* apSrc ){
+    return (uint16_t)( apSrc[0] | ( apSrc[1] << 8 ) );
+}
+
+// record --> frame
+inline void TelemEncode( const TelemetryRecord& acRec, uint8_t* apFrame ){
+
+    apFrame[0] = cTelemSync0;
+    apFrame[1] = cTelemSync1;
+    apFrame[2] = cTelemVersion;
+    apFrame[3] = acRec.seq;
+    TelemPut16( apFrame + 4, (uint16_t)( acRec.timeMs ) );
+    TelemPut16( apFrame + 6, (uint16_t)( acRec.timeMs >> 16 ) );
+    TelemPut16( apFrame + 8, acRec.luxRaw );
+    TelemPut16( apFrame + 10, acRec.luxScaled );
+    apFrame[12] = acRec.gain;
+    apFrame[13] = acRec.flags;
+    TelemPut16( apFrame + 14, acRec.deltaScaler );
+    TelemPut16( apFrame + 16, acRec.triggersAvg );
+    TelemPut16( apFrame + 18, acRec.pulseGain );
+    TelemPut16( apFrame + 20, acRec.pulseRes );
+    apFrame[22] = acRec.numChords;
+    apFrame[23] = acRec.numStrings;
+    apFrame[24] = acRec.numPartials;
+    apFrame[25] = acRec.numPloks;
+    TelemPut16( apFrame + 26, acRec.cpuLoad );
+    apFrame[28] = acRec.shedLevel;
+    TelemPut16( apFrame + 29, acRec.clips );
+    TelemPut16( apFrame + 31, acRec.peak );
+    apFrame[cTelemFrameSize - 1] = TelemCrc8( apFrame, cTelemFrameSize - 1 );
+}
+
+// frame --> record, false on bad sync/version/crc
+inline bool TelemDecode( const uint8_t* apFrame, TelemetryRecord& aRec ){
+
+    if ( apFrame[0] != cTelemSync0 || apFrame[1] != cTelemSync1 || apFrame[2] != cTelemVersion ){
+        return false;
+    }
+    if ( TelemCrc8( apFrame, cTelemFrameSize - 1 ) != apFrame[cTelemFrameSize - 1] ){
+        return false;
+    }
+
+    aRec.seq = apFrame[3];
+    aRec.timeMs = (uint32_t)TelemGet16( apFrame + 4 ) | ( (uint32_t)TelemGet16( apFrame + 6 ) << 16 );
+    aRec.luxRaw = TelemGet16( apFrame + 8 );
+    aRec.luxScaled = TelemGet16( apFrame + 10 );
+    aRec.gain = apFrame[12];
+    aRec.flags = apFrame[13];
+    aRec.deltaScaler = TelemGet16( apFrame + 14 );
+    aRec.triggersAvg = TelemGet16( apFrame + 16 );
+    aRec.pulseGain = TelemGet16( apFrame + 18 );
+    aRec.pulseRes = TelemGet16( apFrame + 20 );
+    aRec.numChords = apFrame[22];
+    aRec.numStrings = apFrame[23];
+    aRec.numPartials = apFrame[24];
+    aRec.numPloks = apFrame[25];
+    aRec.cpuLoad = TelemGet16( apFrame + 26 );
+    aRec.shedLevel = apFrame[28];
+    aRec.clips = TelemGet16( apFrame + 29 );
+    aRec.peak = TelemGet16( apFrame + 31 );
+    return true;
+}
+
+//---------------------------------------------------------
+// byte stream --> records, resyncs on sync bytes after garbage or a bad frame
+class TelemetryParser
+{
+public:
+    TelemetryParser(){}
+    ~TelemetryParser(){}
+
+    // returns true when a valid record has been completed
+    bool Push( const uint8_t acByte, TelemetryRecord& aRec ){
+
+        if ( mLen == 0 && acByte != cTelemSync0 ){
+            return false;
+        }
+        if ( mLen == 1 && acByte != cTelemSync1 ){
+            mLen = ( acByte == cTelemSync0 ) ? 1 : 0;
+            return false;
+        }
+
+        mFrame[mLen++] = acByte;
+        if ( mLen < cTelemFrameSize ){
+            return false;
+        }
+
+        if ( TelemDecode( mFrame, aRec ) ){
+            mLen = 0;
+            return true;
+        }
+        mNumBadFrames++;
+
+        // restart from the next candidate sync byte inside the rejected frame
+        int vstart = 1;
+        while ( vstart < cTelemFrameSize && mFrame[vstart] != cTelemSync0 ){
+            vstart++;
+        }
+        mLen = cTelemFrameSize - vstart;
+        for ( int i = 0; i < mLen; ++i ){
+            mFrame[i] = mFrame[vstart + i];
+        }
+        return false;
+    }
+
+    inline uint32_t NumBadFrames(){ return mNumBadFrames; }
+
+private:
+    uint8_t mFrame[cTelemFrameSize];
+    int mLen{0};
+    uint32_t mNumBadFrames{0};
+};
@@ -13,6 +13,7 @@
 void LarvaChord::Init(const ChordID acChord ){
 
     mID = acChord;
+    mRand.Seed( cRandStreamChord + mID );
     //Serial.print("- Chord: Init with id: "); Serial.println(mID);
   
     for (int i = 0; i < cNumStrings; i++){
@@ -28,6 +29,10 @@ void LarvaChord::Init(const ChordID acChord ){
     }
 
     Retune();
+    PickNextVoicing();
+
+    // setup time, no need to spread
+    while ( PrerollRetune() ){}
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -45,10 +50,18 @@ void LarvaChord::Init(const ChordID acChord ){
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void LarvaChord::Update( const int acLightAvg, const int acLightInput, const int acLightDelta ){
   
+    PROF_SCOPE(kProfChordUpdate);
+
     mTriggered=false;
 
+    // release over: faded out, or all strings muted before the end of
+    // the fade (Process() is not called anymore, the gain would stay > 0)
+    if ( mReleasing && ( mReleaseGain <= 0.f || mNumActiveStrings == 0 ) ){
+        Reset();
+    }
+
     // if slow avg is within the range of this chord
-    if ( acLightAvg >= mLightRangeMin && acLightAvg < mLightRangeMax ){
+    if ( !mReleasing && InRange( acLightAvg ) ){
         for (int s=0; s < cNumStrings; ++s){
             mString[s].UpdateLevels( acLightAvg, acLightDelta );
             
@@ -79,6 +92,16 @@ void LarvaChord::Update( const int acLightAvg, const int acLightInput, const int
 
 }
 
+void LarvaChord::Reset(){
+
+    for (int s=0; s < cNumStrings; ++s){
+        mString[s].Reset();
+    }
+    mNumActiveStrings = 0;
+    mReleasing = false;
+    Mute();
+}
+
 /* Retune
 the 3 strings are tuned to one of the 5 chords, depending on the average light input 
 over a long period the whole range of the light input (0-1050) is divided in 5 equal parts 
@@ -88,12 +111,10 @@ each chord has 4 possible pitches, but we only ever use 3 at a time
 */
 void LarvaChord::Retune(){
 
-    int voicing = random(cNumChordVoicings);
+    int voicing = mRand.Range(cNumChordVoicings);
 
-    #ifdef PRINT
     //Serial.print("- Chord: ");  Serial.print(mID);
     //Serial.print(" Retune to voicing: ");  Serial.println(voicing);
-    #endif
 
      for (int i = 0; i < cNumStrings; i++)
      {
@@ -103,6 +124,18 @@ void LarvaChord::Retune(){
     }
 }
 
+// voicing for the next unmute, see LarvaString::PrerollRetune()
+void LarvaChord::PickNextVoicing(){
+
+    int voicing = mRand.Range(cNumChordVoicings);
+
+    for (int i = 0; i < cNumStrings; i++)
+    {
+        int voice = cChordVoicings[voicing][i];
+        mString[i].SetNextFundamental( cChords[mID][voice] );
+    }
+}
+
 void LarvaChord::SetLightRange(const int acMin, const int acMax){ 
     
     mLightRangeMin=acMin; 
@@ -13,30 +13,74 @@
 void LarvaString::Init(const int acID,  const float acFundFreq ){
 
     mID = acID;
+    mFundFreq = acFundFreq;
+    mNextFund = acFundFreq;
+    mRand.Seed( cRandStreamString + mID );
+    mPlokSynth.Init( mID );
     
-    #ifdef PRINT
     //Serial.print("String: Init with id: "); Serial.print(mID); 
     //Serial.print("\tfund:  "); Serial.println(acFundFreq);
-    #endif
 
     for (int i=0; i<cNumPartials; ++i){
         mSin[i] = Oscil<SIN2048_NUM_CELLS, AUDIO_RATE> (SIN2048_DATA);
-        mSmooth[i] = Smooth <unsigned int>(gcSmoothness);   
+        mSin[i].setPhase( 0 ); // Oscil leaves it uninitialized
+        mSmooth[i].Init(gcSmoothness);
+        mProcPartials[i] = i;
+        #ifdef DRONE_MULTIRATE
+        mSubRate[i] = false;
+        #endif
     }
+    mNumProcPartials = cNumPartials;
+
+    #if defined(DRONE_WAVETABLE)
+    mWave.Init(SIN2048_DATA, AUDIO_RATE);
+    #elif defined(DRONE_RECURSIVE)
+    mBank.Init(AUDIO_RATE);
+    #endif
+}
+
+void LarvaString::Reset(){
+
+    for (int i = 0; i < cNumPartials; ++i){
+        mDroneLevels[i] = 0;
+        mPulseL_levels[i] = 0;
+        mPulseM_levels[i] = 0;
+        mPulseS_levels[i] = 0;
+        mGains[i] = 0;
+        mSmoothGains[i] = 0;
+        mSmooth[i].Init(gcSmoothness);
+    }
+    #ifdef DRONE_MULTIRATE
+    // the sub rate ramp would resume from the released level
+    mLowOut = 0.f;
+    mLowStep = 0.f;
+    mSubRateCounter = 0;
+    #endif
+    Mute();
+    mIdle = true;
 }
 
 void LarvaString::Update(){
 
   mTriggered = false;
+
+    // nothing changes until UpdateLevels() bumps a level:
+    // muted --> no decay, levels below thres --> gains & smoothers stay at 0
+    if ( mIdle ){
+        return;
+    }
     
     // update gains
     for (int i = 0; i < cNumPartials; i++) {
 
-        if ( mDroneLevels[i] < cDroneStartThres ) {
+        // levels only decay, no need to evaluate once below thres
+        int vlevel = mDroneLevels[i] < cDroneStartThres ? mDroneLevels[i] : DroneLevel(i);
+
+        if ( vlevel < cDroneStartThres ) {
             mGains[i] = 0;
         } 
         else {
-            mGains[i] = map( mDroneLevels[i], cDroneStartThres, mDroneRange, 0, gain_max );
+            mGains[i] = map( vlevel, cDroneStartThres, mDroneRange, 0, gain_max );
             long exp_scale = ( mGains[i] * mGains[i] * mGains[i]) >> 16;         
 
             // Weight partial gain vs freq
@@ -44,15 +88,28 @@ void LarvaString::Update(){
         }
     }
 
+    if ( mShedPartials > 0 ){
+        ShedPartials();
+    }
+
     // update smooth gains
     for (int i = 0; i < cNumPartials; ++i) {
-        mSmoothGains[i] = mSmooth[i].next(mGains[i]);
+        mSmoothGains[i] = mSmooth[i].Next(mGains[i]);
     }
 
+    #if defined(DRONE_WAVETABLE)
+    mWave.SetGains(mSmoothGains);
+    #elif defined(DRONE_RECURSIVE)
+    mBank.SetGains(mSmoothGains);
+    #endif
+
+
     // compute an overall gain sum
     long smooth_gains_sum = 0;
+    int vgains_sum = 0;
     for (int i = 0; i < cNumPartials; ++i) {
         smooth_gains_sum += mSmoothGains[i];
+        vgains_sum += mGains[i];
     }
 
     // drone at minimum? then mute string
@@ -67,14 +124,8 @@ void LarvaString::Update(){
     // section performed only if playing
     if (mActive){
         
-        // Decrease Drone Levels
-        unsigned long time_now = millis();
-        if ( time_now - mDecreaseTime > cDroneDecreaseRate ) {
-            for (int i = 0; i < cNumPartials; i++) {
-            mDroneLevels[i] = max( mDroneLevels[i] - mDroneDecreaseStep[i], 0 ); 
-            }
-            mDecreaseTime = time_now;
-        }
+        // Decrease Drone Levels, see DroneLevel()
+        mDecayClock++;
 
         // Pulses
         for (int i = 0; i < cNumPartials; i++) 
@@ -100,12 +151,33 @@ void LarvaString::Update(){
             float vlfo = mLFO.Get();
             for (int i = 0; i < cNumPartials; ++i) {
                     mFreq[i] = mBaseFreq[i] + mDetune[i] * vlfo;
-                    mSin[i].setFreq( mFreq[i] );
             }
+            SetOscFreqs();
             mLFOUpdateTimer=0;
         }
 
     } // if active
+
+    // while shedding, silent partials are not rendered
+    // (their oscillators stop, the phase does not matter at gain 0).
+    // After the retune & lfo, so the sub rate split matches the osc freqs
+    mNumProcPartials = 0;
+    #ifdef DRONE_MULTIRATE
+    mNumLowPartials = 0;
+    #endif
+    for (int i = 0; i < cNumPartials; ++i) {
+        if ( mShedPartials == 0 || mSmoothGains[i] > 0 || mGains[i] > 0 ){
+            #ifdef DRONE_MULTIRATE
+            if ( mSubRate[i] ){
+                mLowPartials[mNumLowPartials++] = i;
+                continue;
+            }
+            #endif
+            mProcPartials[mNumProcPartials++] = i;
+        }
+    }
+
+    mIdle = !mActive && smooth_gains_sum == 0 && vgains_sum == 0;
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -113,67 +185,137 @@ void LarvaString::Update(){
 void LarvaString::UpdateLevels( const int acLightInput, const int acLightDelta ){
 
     // light change trigger
-    if ( acLightDelta >= cLightTriggerTreshold ) 
+    if ( acLightDelta >= cLightTriggerTreshold && acLightInput >= mLightRangeMin && mLightRange12 > 0 ) 
     {
-        // bump up levels
-        for (int i = 0; i < cNumPartials; i++) { 
-        
-            // within harmonic range?
-            if ( acLightInput >= mLightRangeMin[i] && acLightInput < mLightRangeMax[i] ) { 
-
-                // increase and clip levels
-                mDroneLevels[i] = min( mDroneLevels[i] + acLightDelta, mDroneRange ); 
-                mPulseL_levels[i] += acLightDelta;
-                mPulseM_levels[i] += acLightDelta;
-                mPulseS_levels[i] += acLightDelta;
-
-                //Serial.print("String "); Serial.print(mID);
-                //Serial.print(" drone level: ");
-                //Serial.println(mDroneLevels[i]);
+        // harmonic range containing the input
+        int i = ( acLightInput - mLightRangeMin ) / mLightRange12;
+        if ( i < cNumPartials ) { 
+
+            // increase and clip levels
+            FoldDroneLevel(i);
+            mDroneLevels[i] = min( mDroneLevels[i] + acLightDelta, mDroneRange ); 
+            mPulseL_levels[i] += acLightDelta;
+            mPulseM_levels[i] += acLightDelta;
+            mPulseS_levels[i] += acLightDelta;
+            mIdle = false;
+
+            //Serial.print("String "); Serial.print(mID);
+            //Serial.print(" drone level: ");
+            //Serial.println(mDroneLevels[i]);
+        }
+    }
+}
+
+// load shedding: at most cNumPartials - mShedPartials sounding partials,
+// the target gain of the quietest ones above the budget goes to 0
+// and the smoothers fade them out.
+// Ranked by smoothed gain so the shed ones stay the quietest while fading.
+// DRONE_WAVETABLE: every gain step is a table update @kr, a fade would 
+// cost one per tick: shed partials drop out of the table at once.
+void LarvaString::ShedPartials(){
+
+    int vexcess = mShedPartials - cNumPartials;
+    for ( int i = 0; i < cNumPartials; ++i ){
+        vexcess += mGains[i] > 0 ? 1 : 0;
+    }
+
+    bool vshed[cNumPartials] = {false};
+    for ( int n = 0; n < vexcess; ++n ){
+        int vmin = -1;
+        for ( int i = 0; i < cNumPartials; ++i ){
+            if ( !vshed[i] && mGains[i] > 0 && ( vmin < 0 || mSmoothGains[i] < mSmoothGains[vmin] ) ){
+                vmin = i;
             }
         }
+        if ( vmin < 0 ){
+            return;
+        }
+        vshed[vmin] = true;
+        mGains[vmin] = 0;
+        #if defined(DRONE_WAVETABLE)
+        mSmooth[vmin].Init(gcSmoothness);
+        #endif
     }
 }
 
 void LarvaString::Retune(const float acFundamental) {
   
+    PROF_SCOPE(kProfRetune);
+
+    PrepareTuning(acFundamental);
+    ApplyTuning();
+}
+
+void LarvaString::RetuneNext(){
+
+    PROF_SCOPE(kProfRetune);
+
+    if ( !mRetuneReady ){
+        PrepareTuning(mNextFund);
+    }
+    ApplyTuning();
+}
+
+// computes the tuning for acFundamental into mNext*, no audible change
+void LarvaString::PrepareTuning(const float acFundamental) {
+
   // the cutoff frequency determines from which partial above the fundamental 
   // we start on one string (1-3) partial 1 is the fundamental etc
   // when the fundamental of the string is set, this value is picked at random, 
   // with a higher waiting of the lower values compared to the higher values
-    mCutoffPartial = rand(MaxTuningOffset) + 1;
+    mNextCutoffPartial = mRand.Range(MaxTuningOffset) + 1;
 
-    #ifdef PRINT
         //Serial.print("-- String "); Serial.print(mID);
-        //Serial.print(" sets cutoff at: ");  Serial.print(mCutoffPartial);
+        //Serial.print(" sets cutoff at: ");  Serial.print(mNextCutoffPartial);
         //Serial.print(" fund: ");  Serial.println(acFundamental);
-        #endif
 
-    mFundFreq = acFundamental;
+    mNextFund = acFundamental;
 
     for (int i = 0; i < cNumPartials; i++) {
 
-        mBaseFreq[i] = mFundFreq * ( mCutoffPartial + i );
+        mNextBaseFreq[i] = mNextFund * ( mNextCutoffPartial + i );
         
         // add random detune
-        float vdet = cDetuneFactor * mBaseFreq[i];
-        mDetune[i] = ( random(2000)*0.001f - 1.f ) * vdet;
-        mFreq[i] = mBaseFreq[i] + mDetune[i];
-        mSin[i].setFreq( mFreq[i] ); 
+        float vdet = cDetuneFactor * mNextBaseFreq[i];
+        mNextDetune[i] = mRand.Bipolar() * vdet;
+        float vfreq = mNextBaseFreq[i] + mNextDetune[i];
 
         // set decrease step according to master value & freq curve
-        float vscaler = FreqScaler(mFreq[i],cDecrCutoff,cDecrFreqMax,cDecrHF,cDecrSlope);
+        float vscaler = FreqScaler(vfreq,cDecrCutoff,cDecrFreqMax,cDecrHF,cDecrSlope);
         vscaler = vscaler > 1e-5f ? vscaler : 1e-5f;
-        mDroneDecreaseStep[i] = (int)( mDroneDecreaseStepMaster / vscaler );
+        mNextDecreaseStep[i] = (int)( mDroneDecreaseStepMaster / vscaler );
         
-        #ifdef PRINT
-        //Serial.print("\tFreq: ");  Serial.print(mFreq[i]);
+        //Serial.print("\tFreq: ");  Serial.print(vfreq);
         //Serial.print("\tdecrstep: ");  Serial.println(mDroneDecreaseStep[i]);
         //Serial.print("-- String "); Serial.print(mID);
         //Serial.print(" tune partial: ");  Serial.print(i);
-        //Serial.print(" at freq: ");  Serial.println(mFreq[i]);
-        #endif
-  }
+        //Serial.print(" at freq: ");  Serial.println(vfreq);
+    }
+
+    mRetuneReady = true;
+}
+
+// swaps the prepared tuning in
+void LarvaString::ApplyTuning(){
+
+    mFundFreq = mNextFund;
+    mCutoffPartial = mNextCutoffPartial;
+
+    for (int i = 0; i < cNumPartials; i++) {
+        mBaseFreq[i] = mNextBaseFreq[i];
+        mDetune[i] = mNextDetune[i];
+        mFreq[i] = mBaseFreq[i] + mDetune[i];
+        // the decay so far at the old step
+        FoldDroneLevel(i);
+        mDroneDecreaseStep[i] = mNextDecreaseStep[i];
+    }
+
+    #ifdef DRONE_WAVETABLE
+    mWave.SetHarmonics(mCutoffPartial);
+    #endif
+    SetOscFreqs();
+
+    mRetuneReady = false;
 }
 
 /*
@@ -185,7 +327,7 @@ then choose another random (weighted) value
 */
 void LarvaString::UpdateCutoffLevel(){
     
-    mCutoffPartial = rand(3) + 1;
+    mCutoffPartial = mRand.Range(3) + 1;
 
     //Serial.print("-- String "); Serial.print(mID);
     //Serial.print(" UpdateCutoff: ");  Serial.println(mCutoffPartial);
@@ -198,18 +340,24 @@ void LarvaString::UpdateCutoffLevel(){
         //float vdet = cDetuneFactor * mBaseFreq[i];
         //mDetune[i] = map( random(1001), 0.f, 1000.f, -vdet, vdet );
         mFreq[i] = mBaseFreq[i] + mDetune[i];
-        mSin[i].setFreq( mFreq[i] ); 
   }
+
+    #ifdef DRONE_WAVETABLE
+    mWave.SetHarmonics(mCutoffPartial);
+    #endif
+    SetOscFreqs();
 }
 
 void LarvaString::TriggerRandomPulse( const int acVoice, 
                                       const float acFreq, 
                                       const float acGain )
 {
+    PROF_SCOPE(kProfPlokTrigger);
+
     // dither plok params
-    float vrand = ( (float)rand(2000) * 0.001f - 1.f ) * cPulseResonanceRandRange;
+    float vrand = mRand.Bipolar() * cPulseResonanceRandRange;
     float q = mPulseResonanceAvg + vrand;
-    int d = cPlokImpulseDurMin + rand(cPlokImpulseDurRange);
+    int d = cPlokImpulseDurMin + mRand.Range(cPlokImpulseDurRange);
     float vg = acGain * mPulseMasterGain;
     
     mPlokSynth.Trigger( acFreq, q, vg, d );
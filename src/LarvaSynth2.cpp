@@ -26,10 +26,21 @@ static void ComputeFreq2GainTable(){
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // LARVA SYNTH
 
-void LarvaSynth2::Init() 
+void LarvaSynth2::Init( const unsigned long acSeed ) 
 {
-  
+  // seed before the chords pick their first voicings
+  // fixed seed for reproducible renders, 0 = seed from noise
+  if ( acSeed != 0 ){
+    RandSetGlobalSeed( acSeed );
+  }
+  else {
+    randSeed();
+    RandSetGlobalSeed( xorshift96() );
+  }
+  InitPlokNoise();
+
   ComputeFreq2GainTable();
+  ComputePlokCoefTables();
 
   mChords[0].Init(kChord1);
   mChords[0].SetLightRange(0,250);
@@ -46,26 +57,74 @@ void LarvaSynth2::Init()
   mChords[4].Init(kChord5);
   mChords[4].SetLightRange(800,1050);
   
-  mTriggersTimestamp = millis();
-
-  randSeed();
-  startMozzi(CONTROL_RATE);
+  mTriggersTick = 0;
 }
 
 int16_t LarvaSynth2::Process(){
+    PROF_SCOPE(kProfAudio);
+
     float vMix = 0.f;
     for ( int s = 0; s < mNumActiveChords; ++s ){
       vMix += mpActiveChords[s]->Process();
     }
     
-    int16_t vout = ( (int16_t)( vMix * 32000.f ) );
+    return MixOut( (int32_t)vMix );
+}
 
-    return vout;
+void LarvaSynth2::CountVoices( int& aNumStrings, int& aNumPartials, int& aNumPloks ){
+    aNumStrings = 0;
+    aNumPartials = 0;
+    aNumPloks = 0;
+    for ( int s = 0; s < mNumActiveChords; ++s ){
+      aNumStrings += mpActiveChords[s]->NumActiveStrings();
+      aNumPartials += mpActiveChords[s]->NumActivePartials();
+      aNumPloks += mpActiveChords[s]->NumActivePloks();
+    }
+}
+
+// releases chords until at most cNumActiveChordsMax are sustained.
+// Priority: chords whose range contains the slow light average are kept,
+// the quietest (lowest smoothed gain sum) of the others goes first
+void LarvaSynth2::LimitPolyphony( const int acLightSlowAvg ){
+
+    int vnsustained = 0;
+    for ( int s = 0; s < mNumActiveChords; ++s ){
+      vnsustained += mpActiveChords[s]->Releasing() ? 0 : 1;
+    }
+
+    while ( vnsustained > cNumActiveChordsMax ){
+
+      LarvaChord* vvictim = NULL;
+      bool vvictiminrange = false;
+      int vvictimenergy = 0;
+
+      for ( int s = 0; s < mNumActiveChords; ++s ){
+        LarvaChord* vchord = mpActiveChords[s];
+        if ( vchord->Releasing() ){
+          continue;
+        }
+        bool vinrange = vchord->InRange( acLightSlowAvg );
+        int venergy = vchord->Energy();
+        if ( vvictim == NULL || ( vvictiminrange && !vinrange ) 
+              || ( vinrange == vvictiminrange && venergy < vvictimenergy ) ){
+          vvictim = vchord;
+          vvictiminrange = vinrange;
+          vvictimenergy = venergy;
+        }
+      }
+
+      vvictim->Release();
+      vnsustained--;
+    }
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-void LarvaSynth2::Update( const int acLightRaw, const int acLightScaled )
+void LarvaSynth2::Update( const uint32_t acTick, const int acLightRaw, const int acLightScaled, const int acLightGain )
 {
+  PROF_SCOPE(kProfSynthUpdate);
+
+  RefillPlokNoise();
+
   // rolling average of RAW input input for delta detection 
   int vLightAvg = mLightRolling.next(acLightRaw);
 
@@ -75,6 +134,17 @@ void LarvaSynth2::Update( const int acLightRaw, const int acLightScaled )
   // calculate delta btw current reading and average
   int light_delta = abs( acLightRaw - vLightAvg ) * mDeltaScaler; 
 
+  // a gain change steps the raw input (from the next tick, see PhotoSensReader::Flush()):
+  // no delta until the rolling avg is all at the new gain
+  if ( acLightGain != mLightGain ){
+    mLightGain = acLightGain;
+    mLightGainHold = cLightRollingSize + 1;
+  }
+  if ( mLightGainHold > 0 ){
+    mLightGainHold--;
+    light_delta = 0;
+  }
+
   // light change trigger
   mTriggered = ( light_delta > cLightTriggerTreshold );
   
@@ -119,9 +189,8 @@ void LarvaSynth2::Update( const int acLightRaw, const int acLightScaled )
   // in the last period (try 30 secs), the mapping is a bell curve, 
   // where few triggers = lower gain , a moderate amount of triggers == higher gain, 
   // a lot of triggers = lower gain again
-  long vtime = millis();
-  if ( vtime - mTriggersTimestamp > cTriggersinterval ){
-    mTriggersTimestamp = vtime;
+  if ( acTick - mTriggersTick >= cTriggersintervalTicks ){
+    mTriggersTick = acTick;
     mTriggersAvg = mTriggersRolling.next(mTriggersCounter);
     mTriggersCounter = 0;
     mPulseGain = BellCurve( mTriggersAvg, (float)cTriggersAvgMin, (float)cTriggersAvgMax, 
@@ -177,20 +246,6 @@ void LarvaSynth2::Update( const int acLightRaw, const int acLightScaled )
   for (int s=0; s < kNumChords; ++s){
 
     mChords[s].Update( vLightSlowAvg, acLightRaw, light_delta );
-    
-    // limit chords polyphony - useless for now
-    // bool vtriggered = mChords[s].Update( vLightSlowAvg, acLightRaw, light_delta );
-    // limit on num of active chords 
-    /*if ( vtriggered ){
-      if (mNumActiveChords < cNumActiveChordsMax ){
-         mChords[s].Unmute();
-         Serial.print("Trigger Chord: "); Serial.println(s);
-      }
-      else{
-         mChords[s].Reset();
-         Serial.println("discarding chord "); 
-      }
-    }*/
 
     mChords[s].SetPulseMasterGain(mPulseGain);
     mChords[s].SetPulseResonanceAvg(mPulseRes);
@@ -201,6 +256,15 @@ void LarvaSynth2::Update( const int acLightRaw, const int acLightScaled )
     }
   }
 
+  LimitPolyphony( vLightSlowAvg );
+
+  // retune work of muted strings, one string per tick
+  for (int s=0; s < kNumChords; ++s){
+    if ( mChords[s].PrerollRetune() ){
+      break;
+    }
+  }
+
 }
 
 
@@ -13,6 +13,46 @@
 
 #include "../include/Plok.hpp"
 
+//---------------------------------------------------------
+float mPlokSinTable[cPlokSinTableSize + 1];
+float mPlokExpTable[cPlokExpTableSize + 1];
+
+void ComputePlokCoefTables(){
+    for ( int i = 0; i <= cPlokSinTableSize; ++i ){
+        mPlokSinTable[i] = sinf( 0.5f * PI * i / cPlokSinTableSize );
+    }
+    for ( int i = 0; i <= cPlokExpTableSize; ++i ){
+        mPlokExpTable[i] = expf( -PI * i / cPlokExpTableSize );
+    }
+}
+
+//---------------------------------------------------------
+float mPlokNoiseTable[cPlokNoiseTableSize];
+
+static RandStream mPlokNoiseRand;
+static int mPlokNoiseRefillPos{0};
+
+void InitPlokNoise(){
+    mPlokNoiseRand.Seed( cRandStreamNoise );
+    mPlokNoiseRefillPos = 0;
+    for ( int i = 0; i < cPlokNoiseTableSize; ++i ){
+        mPlokNoiseTable[i] = mPlokNoiseRand.Bipolar() * 1.5f;
+    }
+}
+
+void RefillPlokNoise(){
+    for ( int i = 0; i < cPlokNoiseRefillSize; ++i ){
+        mPlokNoiseTable[mPlokNoiseRefillPos + i] = mPlokNoiseRand.Bipolar() * 1.5f;
+    }
+    mPlokNoiseRefillPos = ( mPlokNoiseRefillPos + cPlokNoiseRefillSize ) & ( cPlokNoiseTableSize - 1 );
+}
+
+void PlokSynth::Init( const int acID ){
+    for ( int i = 0; i < cNVoices; ++i ){
+        mVoices[i].Seed( cRandStreamPlok + acID * 16 + i );
+    }
+}
+
 // Triggers a specific voice
 void PlokSynth::TriggerVoice( const int acVoice, const float acFreq, 
                                 const float acQ, const float acGain, const int acImpulseDur ){
@@ -38,7 +78,7 @@ void PlokSynth::Trigger( const float acFreq,
                         const float acGain, 
                         const int acImpulseDur ){
 
-    if ( mNActiveVoices < cNVoices ){
+    if ( mNActiveVoices < mMaxVoices ){
         mVoices[mNActiveVoices++].Trigger( acFreq, acQ, acGain, acImpulseDur );   
     }
 }
@@ -0,0 +1,70 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "Profiler.hpp"
+
+#include <string.h>
+#if !defined(ARDUINO)
+#include <stdio.h>
+#endif
+
+ProfStats Profiler::mStats[kNumProfSections];
+
+static const char* const cProfSectionNames[kNumProfSections] = {
+    "sensor",
+    "synth upd",
+    "chord upd",
+    "retune",
+    "plok trig",
+    "audio",
+};
+
+const char* Profiler::Name( const ProfSection acSection ){
+    return cProfSectionNames[acSection];
+}
+
+void Profiler::Reset(){
+    memset( mStats, 0, sizeof(mStats) );
+}
+
+// one line per section: name, count, min/mean/max (us), histogram counts
+void Profiler::Print(){
+
+    for ( int s = 0; s < kNumProfSections; ++s ){
+
+        const ProfStats& vs = mStats[s];
+        if ( vs.count == 0 ){
+            continue;
+        }
+
+        float vmin = ProfClock::TicksToUs( vs.min );
+        float vmean = ProfClock::TicksToUs( (uint32_t)( vs.sum / vs.count ) );
+        float vmax = ProfClock::TicksToUs( vs.max );
+
+#if defined(ARDUINO)
+        Serial.print(cProfSectionNames[s]);
+        Serial.print("\tn: "); Serial.print(vs.count);
+        Serial.print("\tmin: "); Serial.print(vmin,1);
+        Serial.print("\tmean: "); Serial.print(vmean,1);
+        Serial.print("\tmax: "); Serial.print(vmax,1);
+        Serial.print("\thist:");
+        for ( int b = 0; b < cProfHistBins; ++b ){
+            Serial.print(" "); Serial.print(vs.hist[b]);
+        }
+        Serial.println("");
+#else
+        printf( "%s\tn: %u\tmin: %.1f\tmean: %.1f\tmax: %.1f\thist:",
+                cProfSectionNames[s], (unsigned)vs.count, vmin, vmean, vmax );
+        for ( int b = 0; b < cProfHistBins; ++b ){
+            printf( " %u", (unsigned)vs.hist[b] );
+        }
+        printf( "\n" );
+#endif
+    }
+}
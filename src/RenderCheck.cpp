@@ -0,0 +1,88 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "RenderCheck.hpp"
+#include "LarvaSynth2.hpp"
+#include "LuxScaler.hpp"
+#include "GoldenHashes.hpp"
+
+static const char* const cTraceNames[kNumRenderTraces] = {
+    "kTraceSweep",
+    "kTraceFlicker",
+    "kTraceSteps",
+};
+
+static void PrintHash( const uint32_t acHash ){
+    char vbuf[16];
+    snprintf( vbuf, sizeof(vbuf), "0x%08x,", (unsigned)acHash );
+    Serial.print(vbuf);
+}
+
+int RunRenderCheck(){
+
+    int vnumfailed = 0;
+
+    for ( int t = 0; t < kNumRenderTraces; ++t ){
+
+        // fresh state for each trace, too large for the stack
+        LarvaSynth2* vsynth = new LarvaSynth2();
+        vsynth->Init( cRenderCheckSeed );
+
+        RenderHasher vhasher;
+        vhasher.Reset();
+        int vblock = 0;
+        int vfirstbad = -1;
+
+        Serial.print("    // "); Serial.println(cTraceNames[t]);
+        Serial.print("    {");
+
+        for ( int k = 0; k < cRenderTraceTicks; ++k ){
+            
+            int vraw, vgain;
+            RenderTrace( t, k, vraw, vgain );
+            vsynth->Update( k, vraw, LuxScale( vraw, vgain ), vgain );
+
+            for ( int n = 0; n < AUDIO_RATE / CONTROL_RATE; ++n ){
+                if ( vhasher.Push( vsynth->Process() ) ){
+                    
+                    uint32_t vhash = vhasher.LastHash();
+                    if ( vblock % 8 == 0 ){
+                        Serial.print("\n        ");
+                    }
+                    PrintHash( vhash );
+
+                    if ( cGoldenCaptured[t] && vfirstbad < 0 && vhash != cGoldenHashes[t][vblock] ){
+                        vfirstbad = vblock;
+                    }
+                    vblock++;
+                }
+            }
+        }
+        Serial.println("\n    },");
+
+        delete vsynth;
+
+        if ( !cGoldenCaptured[t] ){
+            Serial.print("// "); Serial.print(cTraceNames[t]); Serial.println(": not captured");
+        }
+        else if ( vfirstbad >= 0 ){
+            vnumfailed++;
+            Serial.print("// "); Serial.print(cTraceNames[t]); 
+            Serial.print(": DIVERGED at block "); Serial.print(vfirstbad);
+            Serial.print(" (t = "); 
+            Serial.print( (float)vfirstbad * cRenderHashBlockSize / AUDIO_RATE, 2 );
+            Serial.println(" s)");
+        }
+        else {
+            Serial.print("// "); Serial.print(cTraceNames[t]); Serial.println(": ok");
+        }
+    }
+
+    return vnumfailed;
+}
@@ -14,34 +14,218 @@
 LarvaSynth2 mSynth;
 PhotoSensReader mPhotoSensReader;
 
+// timebase, see LarvaDefs.hpp
+uint32_t mControlTick{0};
+uint64_t mSampleCount{0};
+
+#ifdef PROFILE
+int mProfReportCounter{0};
+#endif
+
+#ifdef RENDER_CHECK
+#include "RenderCheck.hpp"
+#endif
+
+#if defined(LIGHT_REPLAY)
+#include "LightTraceRecorder.hpp"
+
+LightTraceFileSource mTraceFile;
+ReplayLightSource<LightTraceFileSource> mLightSource( mTraceFile );
+#elif defined(LIGHT_SYNTH)
+#include "SynthLightSources.hpp"
+
+// load test: full depth flicker @ control rate / 4, max triggers
+FlickerLightSource mLightSource( 2000.f, 1.f, CONTROL_RATE / 4.f, CONTROL_RATE );
+#elif defined(SENSOR_OVERSAMPLE)
+#include "LightSampler.hpp"
+
+AdcLightSource mAdcSensor;
+SensorLightSource mLightSource( mAdcSensor );
+LightSampler mLightSampler;
+#endif
+
+#if defined(LIGHT_TRACE) || defined(LIGHT_TRACE_DUMP)
+#include "LightTraceRecorder.hpp"
+
+LightTraceRecorder mTraceRecorder;
+#endif
+
+#if defined(TELEMETRY) || defined(LOAD_GOVERNOR)
+#include "LoadMeter.hpp"
+
+LoadMeter mLoadMeter;
+#endif
+
+#ifdef LOAD_GOVERNOR
+#include "LoadGovernor.hpp"
+
+LoadGovernor mLoadGovernor;
+int mShedLevel{0};
+#endif
+
+#ifdef TELEMETRY
+#include "Telemetry.hpp"
+
+Telemetry mTelemetry;
+int mTelemetryCounter{0};
+uint32_t mTelemetryClips{0};
+
+void sendTelemetry(){
+  TelemetryRecord vrec;
+  vrec.timeMs = SamplesToMs( mSampleCount );
+  vrec.luxRaw = (uint16_t)mPhotoSensReader.GetLuxRaw();
+  vrec.luxScaled = (uint16_t)mPhotoSensReader.GetLuxScaled();
+  vrec.gain = (uint8_t)mPhotoSensReader.GetGain();
+  vrec.flags = ( mPhotoSensReader.Saturated() ? kTelemSaturated : 0 ) 
+             | ( mPhotoSensReader.Calibrating() ? kTelemCalibrating : 0 );
+  vrec.deltaScaler = (uint16_t)( mSynth.GetDeltaScaler() * 1000.f );
+  vrec.triggersAvg = (uint16_t)mSynth.GetTriggersAvg();
+  vrec.pulseGain = (uint16_t)( mSynth.GetPulseGain() * 1000.f );
+  vrec.pulseRes = (uint16_t)( mSynth.GetPulseRes() * 100.f );
+
+  int vnstrings, vnpartials, vnploks;
+  mSynth.CountVoices( vnstrings, vnpartials, vnploks );
+  vrec.numChords = (uint8_t)mSynth.NumActiveChords();
+  vrec.numStrings = (uint8_t)vnstrings;
+  vrec.numPartials = (uint8_t)vnpartials;
+  vrec.numPloks = (uint8_t)vnploks;
+  vrec.cpuLoad = (uint16_t)( mLoadMeter.Load() * 1000.f );
+  #ifdef LOAD_GOVERNOR
+  vrec.shedLevel = (uint8_t)mShedLevel;
+  #else
+  vrec.shedLevel = 0;
+  #endif
+
+  uint32_t vclips = mSynth.GetClipCount() - mTelemetryClips;
+  mTelemetryClips += vclips;
+  vrec.clips = (uint16_t)( vclips > 0xFFFF ? 0xFFFF : vclips );
+  vrec.peak = (uint16_t)( mSynth.TakePeak() * 1000 / 32767 );
+
+  mTelemetry.Push( vrec );
+}
+#endif
+
 void setup()
 {
-  #ifdef PRINT
-  Serial.begin(9600);
+  #ifdef PROFILE
+  // no wait for a host, the reports are lost until one listens
+  Serial.begin(cProfBaud);
+  #endif
+
+  #if defined(LIGHT_TRACE_DUMP)
+  Serial.begin(cTelemetryBaud);
+  delay(2000);
+  LightTraceRecorder::DumpToSerial();
+  #elif defined(LIGHT_TRACE)
+  mTraceRecorder.Init();
+  #endif
+
+  #ifdef TELEMETRY
+  // no wait for a host, frames are dropped until the uart drains
+  mTelemetry.Init();
+  #endif
+
+  #ifdef RENDER_CHECK
+  // offline render only, no audio out
+  Serial.begin(cRenderCheckBaud);
   while(!Serial);
+  int vfailed = RunRenderCheck();
+  Serial.print("render check done, diverged traces: "); Serial.println(vfailed);
+  for(;;){ delay(1000); }
   #endif
 
   // amp enable
   pinMode(cAmpEnablePin, OUTPUT);
   digitalWrite(cAmpEnablePin, HIGH);
   
+  #if defined(LIGHT_REPLAY)
+  if ( !mTraceFile.Open() ){
+    // nothing to replay, don't run the synth on zeros
+    Serial.begin(9600);
+    Serial.println("LIGHT_REPLAY: no valid light trace, record one with LIGHT_TRACE first");
+    for(;;){ delay(1000); }
+  }
+  mPhotoSensReader.Init( &mLightSource );
+  #elif defined(LIGHT_SYNTH)
+  mPhotoSensReader.Init( &mLightSource );
+  #elif defined(SENSOR_OVERSAMPLE)
+  mPhotoSensReader.Init( &mLightSource );
+  mLightSampler.Start( &mLightSource );
+  #else
   mPhotoSensReader.Init();
+  #endif
   mSynth.Init();
   mSynth.Start();
 }
 
 void updateControl(){
-  mPhotoSensReader.Update();  
+  #if defined(TELEMETRY) || defined(LOAD_GOVERNOR)
+  mLoadMeter.Begin();
+  #endif
+
+  mControlTick++;
+
+  mPhotoSensReader.Update( mControlTick );  
   int vluxraw = mPhotoSensReader.GetLuxRaw();
   int vluxscaled = mPhotoSensReader.GetLuxScaled();
-  mSynth.Update( vluxraw, vluxscaled );
+  mSynth.Update( mControlTick, vluxraw, vluxscaled, mPhotoSensReader.GetGain() );
+
+  #if defined(LIGHT_TRACE) && !defined(LIGHT_TRACE_DUMP)
+  mTraceRecorder.Record( vluxraw, mPhotoSensReader.GetGain() );
+  #endif
+
+  #ifdef PROFILE
+  // print & restart stats, printing time is not measured
+  if ( ++mProfReportCounter >= cProfReportInterval ){
+    mProfReportCounter = 0;
+    Profiler::Print();
+    Profiler::Reset();
+  }
+  #endif
+
+  #if defined(TELEMETRY) || defined(LOAD_GOVERNOR)
+  mLoadMeter.End();
+  mLoadMeter.Update();
+  #endif
+
+  #ifdef LOAD_GOVERNOR
+  // applies from the next tick
+  int vshed = mLoadGovernor.Update( mLoadMeter.Load() );
+  if ( vshed != mShedLevel ){
+    mShedLevel = vshed;
+    mSynth.SetShedLevel( mShedLevel );
+  }
+  #endif
+
+  #ifdef TELEMETRY
+  if ( ++mTelemetryCounter >= cTelemetryInterval ){
+    mTelemetryCounter = 0;
+    sendTelemetry();
+  }
+  #endif
 }
 
 int updateAudio(){
+  mSampleCount++;
+
+  #if defined(TELEMETRY) || defined(LOAD_GOVERNOR)
+  mLoadMeter.Begin();
+  int vout = mSynth.Process();
+  mLoadMeter.End();
+  return vout;
+  #else
   return mSynth.Process();
+  #endif
   //return 0;
 }
 
 void loop(){  
   audioHook();
+
+  // pending gain change, kept out of the control tick
+  mPhotoSensReader.Flush();
+
+  #ifdef TELEMETRY
+  mTelemetry.Drain();
+  #endif
 }
\ No newline at end of file
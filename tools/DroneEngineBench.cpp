@@ -0,0 +1,431 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host benchmark: drone engines vs the additive engine
+//
+// build:  g++ -O2 -I include -o dronebench tools/DroneEngineBench.cpp
+// usage:  dronebench
+//
+// random strings as LarvaString plays them (fundamentals of the chords,
+// cutoff partial 1-3, +-1% detune, 12 gains). The additive reference
+// is 12 table oscillators as Mozzi's Oscil<SIN2048_NUM_CELLS>.
+// cost:      ns per sample, control rate work (gain ramps, lfo) included.
+//            Median of cBenchRuns runs over all strings, the engines
+//            interleaved in each run; min-max of the runs in brackets.
+//            Host timings only hint at the device: compare there with
+//            PROFILE (kProfAudio)
+// deviation: per partial level (spectral peak) vs the reference,
+//            partial freq error, energy away from the partials
+// drift:     recursive oscillators, peak amplitude after 10 minutes of lfo
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <stdio.h>
+#include <math.h>
+#include <complex>
+#include <chrono>
+#include <algorithm>
+#include "DroneWavetable.hpp"
+#include "RecursiveSineBank.hpp"
+#include "RandStream.hpp"
+#include "FloatEnv.hpp"
+
+static const float cSampleRate = 32768.f;
+static const int cNumPartials = 12;
+static const int cTickSamples = 512;       // AUDIO_RATE / CONTROL_RATE
+static const int cLFOTicks = 10;           // cLFOUpdateInterval
+static const int cNumStrings = 20;
+static const int cBenchTicks = 64 * 4;     // 4s per string
+static const int cBenchRuns = 15;
+static const int cFFTSize = 32768;         // 1s, 1Hz bins
+
+static const float cFunds[] = { 110.f, 137.5f, 165.f, 185.6f, 220.f, 278.4f, 371.25f };
+
+int8_t mSin2048[cDroneWaveSinSize];
+
+//---------------------------------------------------------
+struct StringSetup
+{
+    int cutoff;
+    float base[cNumPartials];
+    float detune[cNumPartials];
+    uint8_t gains[cNumPartials];
+};
+
+static void RandomString( RandStream& aRand, StringSetup& aString ){
+    float vfund = cFunds[ aRand.Range( sizeof(cFunds) / sizeof(cFunds[0]) ) ];
+    aString.cutoff = aRand.Range( 3 ) + 1;
+    for ( int i = 0; i < cNumPartials; ++i ){
+        aString.base[i] = vfund * ( aString.cutoff + i );
+        aString.detune[i] = aRand.Bipolar() * 0.01f * aString.base[i];
+        // cubic level curve as LarvaString::Update
+        int vg = aRand.Range( 256 );
+        aString.gains[i] = (uint8_t)( ( vg * vg * vg ) >> 16 );
+    }
+}
+
+//---------------------------------------------------------
+// as Oscil<SIN2048_NUM_CELLS, AUDIO_RATE>
+class AdditiveEngine
+{
+public:
+    void Init( const int8_t*, const float ){}
+    void SetHarmonics( const int ){}
+
+    void SetGains( const uint8_t* apGains ){
+        for ( int i = 0; i < cNumPartials; ++i ){
+            mGains[i] = apGains[i];
+        }
+    }
+
+    void SetFreqs( const float* apFreqs ){
+        for ( int i = 0; i < cNumPartials; ++i ){
+            mInc[i] = (uint32_t)( ( 2048.f * apFreqs[i] ) / cSampleRate * 65536.f );
+        }
+    }
+
+    inline int32_t Next(){
+        int32_t vsum = 0;
+        for ( int i = 0; i < cNumPartials; ++i ){
+            mPhase[i] += mInc[i];
+            vsum += mSin2048[ ( mPhase[i] >> 16 ) & 2047 ] * mGains[i];
+        }
+        return vsum;
+    }
+
+private:
+    uint32_t mPhase[cNumPartials] = {};
+    uint32_t mInc[cNumPartials] = {};
+    int mGains[cNumPartials] = {};
+};
+
+//---------------------------------------------------------
+class RecursiveEngine : public RecursiveSineBank<cNumPartials>
+{
+public:
+    void Init( const int8_t*, const float acSampleRate ){
+        RecursiveSineBank<cNumPartials>::Init( acSampleRate );
+    }
+    void SetHarmonics( const int ){}
+};
+
+// peak |y| / cRecursiveSineAmp - 1 over the last second of acSeconds, lfo running
+static double RecursiveDrift( const StringSetup& acString, const int acSeconds ){
+
+    RecursiveSineBank<cNumPartials>* vbank = new RecursiveSineBank<cNumPartials>();
+    vbank->Init( cSampleRate );
+    uint8_t vgains[cNumPartials];
+    float vfreqs[cNumPartials];
+
+    double vworst = 0.0;
+    for ( int p = 0; p < cNumPartials; ++p ){
+
+        // one partial at a time, full gain
+        for ( int i = 0; i < cNumPartials; ++i ){
+            vgains[i] = i == p ? 255 : 0;
+        }
+        float vpeak = 0.f;
+        int vticks = acSeconds * ( (int)cSampleRate / cTickSamples );
+        for ( int t = 0; t < vticks; ++t ){
+            vbank->SetGains( vgains );
+            if ( t % cLFOTicks == 0 ){
+                float vlfo = (float)( t % 640 ) / 640.f;
+                for ( int i = 0; i < cNumPartials; ++i ){
+                    vfreqs[i] = acString.base[i] + acString.detune[i] * vlfo;
+                }
+                vbank->SetFreqs( vfreqs );
+            }
+            for ( int n = 0; n < cTickSamples; ++n ){
+                float vy = fabsf( vbank->Next() ) / 255.f;
+                if ( t >= vticks - (int)cSampleRate / cTickSamples ){
+                    vpeak = vy > vpeak ? vy : vpeak;
+                }
+            }
+        }
+        double vdev = fabs( vpeak / cRecursiveSineAmp - 1.0 );
+        vworst = vdev > vworst ? vdev : vworst;
+    }
+    delete vbank;
+    return vworst;
+}
+
+//---------------------------------------------------------
+static void FFT( std::complex<double>* apData, const int acSize ){
+
+    for ( int i = 1, j = 0; i < acSize; ++i ){
+        int vbit = acSize >> 1;
+        for ( ; j & vbit; vbit >>= 1 ){
+            j ^= vbit;
+        }
+        j ^= vbit;
+        if ( i < j ){
+            std::swap( apData[i], apData[j] );
+        }
+    }
+    for ( int vlen = 2; vlen <= acSize; vlen <<= 1 ){
+        std::complex<double> vw = std::polar( 1.0, -2.0 * M_PI / vlen );
+        for ( int i = 0; i < acSize; i += vlen ){
+            std::complex<double> vt( 1.0, 0.0 );
+            for ( int j = 0; j < vlen / 2; ++j ){
+                std::complex<double> vu = apData[i + j];
+                std::complex<double> vv = apData[i + j + vlen / 2] * vt;
+                apData[i + j] = vu + vv;
+                apData[i + j + vlen / 2] = vu - vv;
+                vt *= vw;
+            }
+        }
+    }
+}
+
+// hann windowed power spectrum of acSize samples, static gains, lfo at 1 (as after a retune)
+template <class TEngine>
+static void Spectrum( const StringSetup& acString, double* apPower ){
+
+    static std::complex<double> vbuf[cFFTSize];
+    TEngine* veng = new TEngine();
+    veng->Init( mSin2048, cSampleRate );
+    float vfreqs[cNumPartials];
+    for ( int i = 0; i < cNumPartials; ++i ){
+        vfreqs[i] = acString.base[i] + acString.detune[i];
+    }
+    veng->SetHarmonics( acString.cutoff );
+    veng->SetGains( acString.gains );
+    veng->SetFreqs( vfreqs );
+
+    for ( int n = 0; n < cFFTSize; ++n ){
+        double vwin = 0.5 - 0.5 * cos( 2.0 * M_PI * n / cFFTSize );
+        vbuf[n] = std::complex<double>( veng->Next() * vwin, 0.0 );
+    }
+    delete veng;
+
+    FFT( vbuf, cFFTSize );
+    for ( int k = 0; k < cFFTSize / 2; ++k ){
+        apPower[k] = std::norm( vbuf[k] );
+    }
+}
+
+// ns per sample: gain ramps @kr (smoothed levels move every tick), lfo every cLFOTicks
+template <class TEngine>
+static double Bench( const StringSetup& acString, int64_t& aSink ){
+
+    TEngine* veng = new TEngine();
+    veng->Init( mSin2048, cSampleRate );
+    uint8_t vgains[cNumPartials];
+    float vfreqs[cNumPartials];
+    for ( int i = 0; i < cNumPartials; ++i ){
+        vgains[i] = acString.gains[i];
+        vfreqs[i] = acString.base[i] + acString.detune[i];
+    }
+    veng->SetHarmonics( acString.cutoff );
+    veng->SetFreqs( vfreqs );
+
+    int64_t vsink = 0;
+    auto vstart = std::chrono::steady_clock::now();
+    for ( int t = 0; t < cBenchTicks; ++t ){
+        for ( int i = 0; i < cNumPartials; ++i ){
+            vgains[i] = vgains[i] > 0 ? vgains[i] - 1 : 0;
+        }
+        veng->SetGains( vgains );
+        if ( t % cLFOTicks == 0 ){
+            float vlfo = (float)( t % 64 ) / 64.f;
+            for ( int i = 0; i < cNumPartials; ++i ){
+                vfreqs[i] = acString.base[i] + acString.detune[i] * vlfo;
+            }
+            veng->SetFreqs( vfreqs );
+        }
+        for ( int n = 0; n < cTickSamples; ++n ){
+            vsink += veng->Next();
+        }
+    }
+    auto vend = std::chrono::steady_clock::now();
+    delete veng;
+
+    aSink += vsink;
+    double vns = std::chrono::duration<double, std::nano>( vend - vstart ).count();
+    return vns / ( (double)cBenchTicks * cTickSamples );
+}
+
+// partial power: peak bin around acFreq (+-3%) and its 2 neighbours each side,
+// insensitive to where the partial falls between bins
+static double PeakPower( const double* apPower, const float acFreq ){
+    int vlo = (int)( acFreq * 0.97f );
+    int vhi = (int)( acFreq * 1.03f ) + 1;
+    vhi = vhi < cFFTSize / 2 - 2 ? vhi : cFFTSize / 2 - 3;
+    int vpeak = vlo;
+    for ( int k = vlo; k <= vhi; ++k ){
+        vpeak = apPower[k] > apPower[vpeak] ? k : vpeak;
+    }
+    double vsum = 0.0;
+    for ( int k = vpeak - 2; k <= vpeak + 2; ++k ){
+        vsum += apPower[k];
+    }
+    return vsum;
+}
+
+// energy further than 4 bins from any spectral peak of the partials, vs total (dB)
+static double OffPartialDb( const double* apPower, const StringSetup& acString ){
+    static bool vnear[cFFTSize / 2];
+    for ( int k = 0; k < cFFTSize / 2; ++k ){
+        vnear[k] = false;
+    }
+    for ( int i = 0; i < cNumPartials; ++i ){
+        float vf = acString.base[i] + acString.detune[i];
+        int vlo = (int)( vf * 0.97f );
+        int vhi = (int)( vf * 1.03f ) + 1;
+        int vpeak = vlo;
+        for ( int k = vlo; k <= vhi && k < cFFTSize / 2; ++k ){
+            vpeak = apPower[k] > apPower[vpeak] ? k : vpeak;
+        }
+        for ( int k = vpeak - 4; k <= vpeak + 4; ++k ){
+            if ( k >= 0 && k < cFFTSize / 2 ){
+                vnear[k] = true;
+            }
+        }
+    }
+    double vtotal = 0.0;
+    double voff = 0.0;
+    for ( int k = 0; k < cFFTSize / 2; ++k ){
+        vtotal += apPower[k];
+        voff += vnear[k] ? 0.0 : apPower[k];
+    }
+    return 10.0 * log10( ( voff + 1e-30 ) / ( vtotal + 1e-30 ) );
+}
+
+// mean ns per sample over all strings
+template <class TEngine>
+static double BenchAll( const StringSetup* apStrings, int64_t& aSink ){
+    double vns = 0.0;
+    for ( int s = 0; s < cNumStrings; ++s ){
+        vns += Bench<TEngine>( apStrings[s], aSink );
+    }
+    return vns / cNumStrings;
+}
+
+// engine result over all strings
+struct EngineStats
+{
+    double runs[cBenchRuns];
+    double ns{0.0};     // median of the runs
+    double levelMaxDb{0.0};
+    double levelSumDb{0.0};
+    int levelCount{0};
+    double offDb{-200.0};
+};
+
+template <class TEngine>
+static void Evaluate( const StringSetup& acString, const double* apRefPower,
+                      EngineStats& aStats ){
+
+    static double vpower[cFFTSize / 2];
+
+    Spectrum<TEngine>( acString, vpower );
+    for ( int i = 0; i < cNumPartials; ++i ){
+        // audible partials only, > -40dB re full scale gain
+        if ( acString.gains[i] < 3 ){
+            continue;
+        }
+        float vf = acString.base[i] + acString.detune[i];
+        double vdb = 10.0 * log10( PeakPower( vpower, vf ) / PeakPower( apRefPower, vf ) );
+        aStats.levelMaxDb = fabs( vdb ) > aStats.levelMaxDb ? fabs( vdb ) : aStats.levelMaxDb;
+        aStats.levelSumDb += fabs( vdb );
+        aStats.levelCount++;
+    }
+    double voff = OffPartialDb( vpower, acString );
+    aStats.offDb = voff > aStats.offDb ? voff : aStats.offDb;
+}
+
+static void Median( EngineStats& aStats ){
+    double vsorted[cBenchRuns];
+    std::copy( aStats.runs, aStats.runs + cBenchRuns, vsorted );
+    std::sort( vsorted, vsorted + cBenchRuns );
+    aStats.ns = vsorted[cBenchRuns / 2];
+}
+
+static void Print( const char* apName, const EngineStats& acStats, const double acRefNs ){
+    double vmin = *std::min_element( acStats.runs, acStats.runs + cBenchRuns );
+    double vmax = *std::max_element( acStats.runs, acStats.runs + cBenchRuns );
+    printf( "%-10s %6.2f ns/sample [%.2f-%.2f] (x%.2f)  level err mean %.2f max %.2f dB  off-partial %.1f dB\n",
+            apName, acStats.ns, vmin, vmax, acRefNs / acStats.ns,
+            acStats.levelCount > 0 ? acStats.levelSumDb / acStats.levelCount : 0.0,
+            acStats.levelMaxDb, acStats.offDb );
+}
+
+int main(){
+
+    FloatEnvFlushToZero();
+
+    for ( int i = 0; i < cDroneWaveSinSize; ++i ){
+        mSin2048[i] = (int8_t)lrint( 127.0 * sin( 2.0 * M_PI * i / cDroneWaveSinSize ) );
+    }
+
+    RandStream vrand;
+    vrand.Seed( 1 );
+
+    static double vrefpower[cFFTSize / 2];
+    EngineStats vadd, vwave, vrec;
+    double vfreqMaxCents = 0.0;
+    double vfreqSumCents = 0.0;
+    int64_t vsink = 0;
+
+    static StringSetup vstrings[cNumStrings];
+
+    for ( int s = 0; s < cNumStrings; ++s ){
+
+        StringSetup& vstring = vstrings[s];
+        RandomString( vrand, vstring );
+
+        Spectrum<AdditiveEngine>( vstring, vrefpower );
+        Evaluate<AdditiveEngine>( vstring, vrefpower, vadd );
+        Evaluate<DroneWavetable<cNumPartials> >( vstring, vrefpower, vwave );
+        Evaluate<RecursiveEngine>( vstring, vrefpower, vrec );
+
+        // wavetable partial freqs: harmonic x mean fundamental of its table
+        for ( int i = 0; i < cNumPartials; ++i ){
+            double vfund = 0.0;
+            int vn = 0;
+            for ( int j = i % cDroneWaveOscs; j < cNumPartials; j += cDroneWaveOscs ){
+                vfund += ( vstring.base[j] + vstring.detune[j] ) / ( vstring.cutoff + j );
+                vn++;
+            }
+            double vf = vfund / vn * ( vstring.cutoff + i );
+            double vcents = fabs( 1200.0 * log2( vf / ( vstring.base[i] + vstring.detune[i] ) ) );
+            vfreqMaxCents = vcents > vfreqMaxCents ? vcents : vfreqMaxCents;
+            vfreqSumCents += vcents / ( cNumStrings * cNumPartials );
+        }
+    }
+
+    // timing: one warm up run, then the engines in rotating order, so 
+    // clock and cache changes during the runs hit all of them
+    BenchAll<AdditiveEngine>( vstrings, vsink );
+    for ( int r = 0; r < cBenchRuns; ++r ){
+        for ( int k = 0; k < 3; ++k ){
+            switch ( ( r + k ) % 3 ){
+            case 0: vadd.runs[r] = BenchAll<AdditiveEngine>( vstrings, vsink ); break;
+            case 1: vwave.runs[r] = BenchAll<DroneWavetable<cNumPartials> >( vstrings, vsink ); break;
+            default: vrec.runs[r] = BenchAll<RecursiveEngine>( vstrings, vsink ); break;
+            }
+        }
+    }
+    Median( vadd );
+    Median( vwave );
+    Median( vrec );
+
+    printf( "%d strings, %d partials, %d runs\n", cNumStrings, cNumPartials, cBenchRuns );
+    Print( "additive", vadd, vadd.ns );
+    Print( "wavetable", vwave, vadd.ns );
+    Print( "recursive", vrec, vadd.ns );
+    printf( "wavetable partial freq err mean %.1f max %.1f cents (detune approximation)\n",
+            vfreqSumCents, vfreqMaxCents );
+
+    StringSetup vstring;
+    RandomString( vrand, vstring );
+    printf( "recursive amplitude drift after 10 min: %.4f%%\n", 100.0 * RecursiveDrift( vstring, 600 ) );
+
+    return vsink == 0x7fffffff ? 1 : 0;
+}
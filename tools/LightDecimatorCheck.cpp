@@ -0,0 +1,181 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host check: LightDecimator response, as set up for SENSOR_OVERSAMPLE
+//
+// build:  g++ -O2 -I include -o decimcheck tools/LightDecimatorCheck.cpp
+// usage:  decimcheck
+//
+// steady levels come out unchanged, then a sweep of FlickerLightSource
+// rates fed at sample rate. Gain of each rate: fundamental at the control
+// output (where it lands after aliasing) over the fundamental at the input,
+// both from a DFT over a whole number of cycles.
+// Passband up to cPassMaxHz, rejection from the control nyquist up.
+// Exit code 1 on failure.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "LightDecimator.hpp"
+#include "SynthLightSources.hpp"
+
+static const int cSampleRate = 2048;
+static const int cFastDecim = 4;
+static const int cCtrlDecim = 8;
+static const int cCtrlRate = cSampleRate / cFastDecim / cCtrlDecim;
+static const int cSamplesPerCtrl = cFastDecim * cCtrlDecim;
+
+typedef LightDecimator<cFastDecim, cCtrlDecim> Decimator;
+
+// control values skipped while the history fills, then analysed (8s, 0.125Hz bins)
+static const int cNumSkip = 2 * Decimator::cNumTaps / cCtrlDecim;
+static const int cNumCtrl = 8 * cCtrlRate;
+
+// passband limits (dB)
+static const float cPassMaxHz = 12.f;
+static const float cPassMinDb = -1.f;
+static const float cPassMaxDb = 0.5f;
+static const float cEdgeHz = 16.f;
+static const float cEdgeMinDb = -3.f;
+// rejection from the control nyquist up (dB)
+static const float cStopMaxDb = -45.f;
+
+// rates on the 0.125Hz grid, so both DFTs hit a bin;
+// off the exact nyquist and its multiples, see also Collides()
+static const float cRates[] = {
+    0.5f, 2.125f, 5.5f, 9.875f, 11.875f, 15.875f, 24.25f,
+    32.375f, 36.625f, 40.375f, 47.625f, 50.125f, 60.25f, 64.375f,
+    100.125f, 120.125f, 250.625f, 500.125f, 1000.375f
+};
+static const int cNumRates = sizeof( cRates ) / sizeof( cRates[0] );
+
+// square wave harmonics that must not land on the probed frequency
+static const int cMaxHarmonic = 999; // 1/999 = -60dB
+
+// amplitude of the component at acHz in a signal sampled at acRate
+static double Amplitude( const int* apX, const int acNum, const double acHz, const double acRate ){
+    double vre = 0.0;
+    double vim = 0.0;
+    for ( int i = 0; i < acNum; ++i ){
+        double vph = 2.0 * M_PI * acHz * i / acRate;
+        vre += apX[i] * cos( vph );
+        vim += apX[i] * sin( vph );
+    }
+    double vamp = 2.0 * sqrt( vre * vre + vim * vim ) / acNum;
+    // at 0 or nyquist the component is not split in two
+    return ( acHz == 0.0 || 2.0 * acHz == acRate ) ? vamp / 2.0 : vamp;
+}
+
+// where a rate lands at the control rate
+static double Alias( const double acHz ){
+    double vf = fmod( acHz, (double)cCtrlRate );
+    return vf > 0.5 * cCtrlRate ? cCtrlRate - vf : vf;
+}
+
+// harmonics of the square wave above the input nyquist fold at the sample rate,
+// one landing in the passband right where the rate aliases to is input content,
+// not leakage, e.g. the 17th of 120Hz at 8Hz
+static bool Collides( const double acHz ){
+    for ( int k = 3; k <= cMaxHarmonic; k += 2 ){
+        double vf = fmod( k * acHz, (double)cSampleRate );
+        vf = vf > 0.5 * cSampleRate ? cSampleRate - vf : vf;
+        if ( vf < 0.5 * cCtrlRate && Alias( vf ) == Alias( acHz ) ){
+            return true;
+        }
+    }
+    return false;
+}
+
+static int CheckSteady( const int acLevel ){
+    Decimator vdecim;
+    vdecim.Reset();
+    int vnumOut = 0;
+    for ( int i = 0; i < 64 * cSamplesPerCtrl; ++i ){
+        if ( vdecim.Push( acLevel ) ){
+            vnumOut++;
+            if ( vdecim.Value() != acLevel ){
+                printf( "FAIL steady %d: output %d\n", acLevel, vdecim.Value() );
+                return 1;
+            }
+        }
+    }
+    if ( vnumOut < 60 ){
+        printf( "FAIL steady %d: %d outputs\n", acLevel, vnumOut );
+        return 1;
+    }
+    return 0;
+}
+
+int main(){
+
+    int vnumFail = 0;
+
+    const int vlevels[] = { 0, 1, 1234, 2048, cLightDecimOutMax };
+    for ( int i = 0; i < 5; ++i ){
+        vnumFail += CheckSteady( vlevels[i] );
+    }
+
+    static int vin[cNumCtrl * cSamplesPerCtrl];
+    static int vout[cNumCtrl];
+
+    printf( "  rate Hz   at ctrl Hz      gain dB\n" );
+    for ( int r = 0; r < cNumRates; ++r ){
+
+        // mid range, full depth: 2000 <-> 0 counts
+        FlickerLightSource vsrc( 1000.f, 1.f, cRates[r], cSampleRate );
+        vsrc.SetGain( 1 );
+        Decimator vdecim;
+        vdecim.Reset();
+
+        int vnumCtrl = 0;
+        int vnumIn = 0;
+        while ( vnumCtrl < cNumSkip + cNumCtrl ){
+            int vraw = vsrc.Read();
+            if ( vnumCtrl >= cNumSkip ){
+                vin[vnumIn++] = vraw;
+            }
+            if ( vdecim.Push( vraw ) ){
+                if ( vnumCtrl >= cNumSkip ){
+                    vout[vnumCtrl - cNumSkip] = vdecim.Value();
+                }
+                vnumCtrl++;
+            }
+        }
+
+        double vampIn = Amplitude( vin, vnumIn, cRates[r], cSampleRate );
+        double vampOut = Amplitude( vout, cNumCtrl, Alias( cRates[r] ), cCtrlRate );
+        double vdb = 20.0 * log10( ( vampOut + 1e-9 ) / vampIn );
+
+        const char* vfail = NULL;
+        if ( Collides( cRates[r] ) ){
+            vfail = "rate not usable, harmonics fold onto it";
+        }
+        else if ( cRates[r] <= cPassMaxHz && ( vdb < cPassMinDb || vdb > cPassMaxDb ) ){
+            vfail = "passband";
+        }
+        else if ( cRates[r] <= cEdgeHz && vdb < cEdgeMinDb ){
+            vfail = "band edge";
+        }
+        else if ( cRates[r] > 0.5f * cCtrlRate && vdb > cStopMaxDb ){
+            vfail = "alias rejection";
+        }
+        printf( "%9.3f %11.3f %12.1f%s%s\n", cRates[r], Alias( cRates[r] ), vdb,
+                vfail ? "   FAIL " : "", vfail ? vfail : "" );
+        vnumFail += vfail ? 1 : 0;
+    }
+
+    if ( vnumFail > 0 ){
+        printf( "%d failures\n", vnumFail );
+        return 1;
+    }
+    printf( "decimator check ok\n" );
+    return 0;
+}
@@ -0,0 +1,237 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host check: LightTraceCodec round trip
+//
+// build:  g++ -O2 -I include -o tracecheck tools/LightTraceCodecCheck.cpp
+// usage:  tracecheck
+//
+// encodes each case into blocks as LightTraceRecorder does (flush
+// before a block fills up, gaps for dropped ticks), decodes the
+// concatenated blocks and compares tick by tick: exact, or within the
+// dead band for the lossy cases. Also prints the encoded size, the
+// recorder setting must fit a day of noisy input in cLightTraceMaxBytes.
+// Exit code 1 on failure.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "LightTraceCodec.hpp"
+
+// as cLightTraceBlockSize, cLightTraceDeadBand, cLightTraceMaxBytes (LarvaDefs.hpp)
+static const int cBlockSize = 512;
+static const int cDeadBand = 3;
+static const uint32_t cMaxBytes = 1200 * 1024UL;
+
+struct Tick {
+    int raw;
+    int gain;
+    bool gap;   // dropped by the recorder
+};
+
+typedef std::vector<Tick> Trace;
+
+static inline void Add( Trace& aTrace, const int acRaw, const int acGain, const bool acGap = false ){
+    Tick vt = { acRaw, acGain, acGap };
+    aTrace.push_back( vt );
+}
+
+// LightTraceRecorder::Record, minus the queues
+static std::vector<uint8_t> EncodeBlocks( const Trace& acTrace, const int acDeadBand ){
+
+    std::vector<uint8_t> vout;
+    uint8_t vblock[cBlockSize];
+    int vlen = 0;
+    uint32_t vgapTicks = 0;
+
+    LightTraceEncoder venc( acDeadBand );
+    venc.Reset();
+
+    for ( size_t i = 0; i < acTrace.size(); ++i ){
+        if ( acTrace[i].gap ){
+            vgapTicks++;
+            continue;
+        }
+        if ( vgapTicks > 0 ){
+            vlen += venc.EncodeGap( vgapTicks, vblock + vlen );
+            vgapTicks = 0;
+        }
+        vlen += venc.Encode( acTrace[i].raw, acTrace[i].gain, vblock + vlen );
+
+        if ( vlen > cBlockSize - 3 * cLightTraceMaxOpBytes ){
+            vlen += venc.Flush( vblock + vlen );
+            vout.insert( vout.end(), vblock, vblock + vlen );
+            vlen = 0;
+        }
+    }
+    if ( vgapTicks > 0 ){
+        vlen += venc.EncodeGap( vgapTicks, vblock + vlen );
+    }
+    vlen += venc.Flush( vblock + vlen );
+    vout.insert( vout.end(), vblock, vblock + vlen );
+    return vout;
+}
+
+// encoded size to apSize if given
+static bool Check( const char* acName, const Trace& acTrace, const int acDeadBand = 0, size_t* apSize = NULL ){
+
+    std::vector<uint8_t> vdata = EncodeBlocks( acTrace, acDeadBand );
+    LightTraceMemSource vsrc( vdata.data(), vdata.size() );
+    LightTraceDecoder<LightTraceMemSource> vdec( vsrc );
+
+    size_t vnumTicks = 0;
+    long vnumFail = 0;
+    int vraw, vgain;
+    bool vgap;
+
+    while ( vdec.Next( vraw, vgain, vgap ) ){
+        if ( vnumTicks < acTrace.size() ){
+            const Tick& vt = acTrace[vnumTicks];
+            int verr = vraw > vt.raw ? vraw - vt.raw : vt.raw - vraw;
+            bool vok = vgap == vt.gap && ( vgap || ( verr <= acDeadBand && vgain == vt.gain ) );
+            if ( !vok && vnumFail++ < 5 ){
+                printf( "  %s tick %lu: got %d/%d%s, expected %d/%d%s\n", acName, (unsigned long)vnumTicks,
+                        vraw, vgain, vgap ? " gap" : "", vt.raw, vt.gain, vt.gap ? " gap" : "" );
+            }
+        }
+        vnumTicks++;
+    }
+
+    bool vpass = vnumFail == 0 && vnumTicks == acTrace.size() && vdec.NumBadOps() == 0;
+    printf( "%-12s %8lu ticks %8lu bytes %.3f bytes/tick  %s\n", acName,
+            (unsigned long)acTrace.size(), (unsigned long)vdata.size(),
+            (double)vdata.size() / acTrace.size(), vpass ? "ok" : "FAILED" );
+    if ( vnumTicks != acTrace.size() ){
+        printf( "  decoded %lu ticks\n", (unsigned long)vnumTicks );
+    }
+    if ( apSize != NULL ){
+        *apSize = vdata.size();
+    }
+    return vpass;
+}
+
+int main(){
+
+    bool vpass = true;
+    Trace vtrace;
+
+    // flat: runs across the 64 tick run limit and the keyframes
+    for ( uint32_t i = 0; i < 3 * cLightTraceKeyframeInterval + 7; ++i ){
+        Add( vtrace, 1000, 40 );
+    }
+    vpass &= Check( "flat", vtrace );
+
+    // max step: full scale swings, varint deltas
+    vtrace.clear();
+    for ( int i = 0; i < 5000; ++i ){
+        Add( vtrace, ( i & 1 ) ? 4095 : 0, 255 );
+    }
+    vpass &= Check( "max step", vtrace );
+
+    // the limits of each delta op: packed [-4,3], single [-32,31], varint beyond
+    vtrace.clear();
+    {
+        static const int cDeltas[] = { 0, 3, -4, 4, -5, 31, -32, 32, -33, 1, 0, -1 };
+        static const int cNumDeltas = sizeof(cDeltas) / sizeof(cDeltas[0]);
+        int vraw = 2048;
+        for ( int a = 0; a < cNumDeltas; ++a ){
+            for ( int b = 0; b < cNumDeltas; ++b ){
+                vraw += cDeltas[a];
+                Add( vtrace, vraw, 10 );
+                vraw += cDeltas[b];
+                Add( vtrace, vraw, 10 );
+            }
+        }
+    }
+    vpass &= Check( "op limits", vtrace );
+
+    // wraparound: runs of exactly 63/64/65/128 ticks, keyframes falling on
+    // a pending packed pair, raw across the ends of the ADC range
+    vtrace.clear();
+    {
+        static const int cRuns[] = { 63, 64, 65, 128, 1, 129 };
+        int vraw = 0;
+        while ( vtrace.size() < 2 * cLightTraceKeyframeInterval + 3 ){
+            for ( int r = 0; r < 6; ++r ){
+                for ( int i = 0; i < cRuns[r]; ++i ){
+                    Add( vtrace, vraw, 3 );
+                }
+                vraw = vraw == 0 ? 4095 : 0;
+                Add( vtrace, vraw + ( vraw ? -1 : 1 ), 3 );
+            }
+        }
+        for ( uint32_t i = 0; i < cLightTraceKeyframeInterval; ++i ){
+            Add( vtrace, 4094 + ( i & 1 ), 3 );
+        }
+    }
+    vpass &= Check( "wraparound", vtrace );
+
+    // block boundary: varint ops and gain changes every tick fill blocks
+    // at the worst rate, blocks end on every op alignment
+    vtrace.clear();
+    for ( int i = 0; i < 20000; ++i ){
+        Add( vtrace, ( i * 2654435761u ) >> 20, ( i / 3 ) & 0xff );
+    }
+    vpass &= Check( "block bound", vtrace );
+
+    // gaps: at the start, mid stream, back to back with gain changes, at the end
+    vtrace.clear();
+    for ( int i = 0; i < 10; ++i ){
+        Add( vtrace, 0, 0, true );
+    }
+    for ( int i = 0; i < 9000; ++i ){
+        bool vgap = ( i % 1000 ) < ( i / 1000 ) * 20;
+        Add( vtrace, 500 + ( i % 7 ), i / 2000, vgap );
+    }
+    for ( int i = 0; i < 200; ++i ){
+        Add( vtrace, 0, 0, true );
+    }
+    vpass &= Check( "gaps", vtrace );
+
+    // noisy: +-2 LSB on a slow ramp, occasional gain steps
+    vtrace.clear();
+    {
+        uint32_t vstate = 0x1234567;
+        for ( int i = 0; i < 64 * 3600; ++i ){
+            vstate ^= vstate << 13;
+            vstate ^= vstate >> 17;
+            vstate ^= vstate << 5;
+            Add( vtrace, 1500 + i / 200 + (int)( vstate % 5 ) - 2, 20 + i / 50000 );
+        }
+    }
+    vpass &= Check( "noisy 1h", vtrace );
+
+    // same input as recorded on device: within the dead band, a day fits
+    {
+        size_t vsize;
+        vpass &= Check( "noisy 1h db", vtrace, cDeadBand, &vsize );
+        if ( 24 * vsize > cMaxBytes ){
+            printf( "  24h would take %lu bytes, over %lu\n", (unsigned long)( 24 * vsize ), (unsigned long)cMaxBytes );
+            vpass = false;
+        }
+    }
+
+    // dead band on the op limits and the full scale steps
+    vtrace.clear();
+    {
+        int vraw = 2048;
+        for ( int i = 0; i < 20000; ++i ){
+            static const int cDeltas[] = { 0, 1, -3, 4, 3, -4, -1, 40, -2, 2, -40, 4095 };
+            vraw += cDeltas[i % 12];
+            vraw = vraw < 0 ? 0 : vraw > 4095 ? 4095 : vraw;
+            Add( vtrace, vraw, 10 + ( i / 777 ) % 2 );
+        }
+    }
+    vpass &= Check( "steps db", vtrace, cDeadBand );
+
+    printf( "%s\n", vpass ? "all ok" : "FAILED" );
+    return vpass ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host tool for light traces (LIGHT_TRACE recordings)
+//
+// build:  g++ -O2 -I include -o lighttrace tools/LightTraceTool.cpp
+// usage:  lighttrace decode trace.klt > trace.csv
+//         lighttrace encode trace.csv > trace.klt
+//
+// csv columns: tick,raw,gain,scaled (scaled is ignored when encoding)
+// ticks inside a recorder gap are decoded with an empty raw field
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "LightTraceCodec.hpp"
+#include "LuxScaler.hpp"
+
+static int Decode( FILE* apIn ){
+
+    std::vector<uint8_t> vdata;
+    uint8_t vbuf[4096];
+    size_t vn;
+    while ( ( vn = fread( vbuf, 1, sizeof(vbuf), apIn ) ) > 0 ){
+        vdata.insert( vdata.end(), vbuf, vbuf + vn );
+    }
+
+    if ( vdata.size() < (size_t)cLightTraceHeaderSize || LightTraceReadHeader( vdata.data() ) == 0 ){
+        fprintf( stderr, "not a light trace\n" );
+        return 1;
+    }
+    int vrate = LightTraceReadHeader( vdata.data() );
+
+    LightTraceMemSource vsrc( vdata.data() + cLightTraceHeaderSize, vdata.size() - cLightTraceHeaderSize );
+    LightTraceDecoder<LightTraceMemSource> vdec( vsrc );
+
+    printf( "tick,raw,gain,scaled\n" );
+    unsigned long vtick = 0;
+    int vraw, vgain;
+    bool vgap;
+    while ( vdec.Next( vraw, vgain, vgap ) ){
+        if ( vgap ){
+            printf( "%lu,,,\n", vtick++ );
+        }
+        else {
+            printf( "%lu,%d,%d,%d\n", vtick++, vraw, vgain, LuxScale( vraw, vgain ) );
+        }
+    }
+
+    fprintf( stderr, "%lu ticks @ %d Hz, %lu bytes (%.3f bytes/tick), %lu bad ops\n",
+             vtick, vrate, (unsigned long)vdata.size(), 
+             vtick > 0 ? (double)vdata.size() / vtick : 0.,
+             (unsigned long)vdec.NumBadOps() );
+    return 0;
+}
+
+static int Encode( FILE* apIn, const int acControlRate ){
+
+    uint8_t vbuf[cLightTraceMaxOpBytes];
+    LightTraceWriteHeader( vbuf, acControlRate );
+    fwrite( vbuf, 1, cLightTraceHeaderSize, stdout );
+
+    LightTraceEncoder venc;
+    venc.Reset();
+
+    char vline[256];
+    unsigned long vtick;
+    int vraw, vgain;
+    while ( fgets( vline, sizeof(vline), apIn ) ){
+        if ( sscanf( vline, "%lu,%d,%d", &vtick, &vraw, &vgain ) != 3 ){
+            // header or gap line
+            continue;
+        }
+        int vn = venc.Encode( vraw, vgain, vbuf );
+        fwrite( vbuf, 1, vn, stdout );
+    }
+    int vn = venc.Flush( vbuf );
+    fwrite( vbuf, 1, vn, stdout );
+    return 0;
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc < 2 || ( strcmp( argv[1], "decode" ) != 0 && strcmp( argv[1], "encode" ) != 0 ) ){
+        fprintf( stderr, "usage: %s decode|encode [file]\n", argv[0] );
+        return 1;
+    }
+
+    FILE* vin = stdin;
+    if ( argc > 2 ){
+        vin = fopen( argv[2], "rb" );
+        if ( vin == NULL ){
+            fprintf( stderr, "cannot open %s\n", argv[2] );
+            return 1;
+        }
+    }
+
+    int vres = strcmp( argv[1], "decode" ) == 0 ? Decode( vin ) : Encode( vin, 64 );
+
+    if ( vin != stdin ){
+        fclose( vin );
+    }
+    return vres;
+}
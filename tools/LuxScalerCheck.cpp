@@ -0,0 +1,62 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host check: LuxScalerLUT vs LuxScale() float reference
+//
+// build:  g++ -O2 -I include -o luxcheck tools/LuxScalerCheck.cpp
+// usage:  luxcheck
+//
+// all 4096 x 256 raw/gain pairs. Off by one is accepted where the
+// exact value is a rounding tie, the float reference is not exact there.
+// Exit code 1 on failure.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "LuxScaler.hpp"
+
+// distance of the exact scaled value from a .5 tie that still counts as a tie
+static const double cTieTolerance = 1e-3;
+
+int main(){
+
+    static LuxScalerLUT vlut;
+    vlut.Init();
+
+    long vnumDiff = 0;
+    long vnumFail = 0;
+
+    for ( int vgain = 0; vgain < cLuxLutGainSize; ++vgain ){
+        for ( int vraw = 0; vraw < cLuxLutRawSize; ++vraw ){
+
+            int vref = LuxScale( vraw, vgain );
+            int vfast = vlut.Scale( vraw, vgain );
+            if ( vfast == vref ){
+                continue;
+            }
+            vnumDiff++;
+
+            // exact value in double precision
+            double vdb = 20.0 * log10( (double)vraw / ( vgain + 1.0 ) );
+            double vexact = ( vdb - cLuxDbMin ) / ( cLuxDbMax - cLuxDbMin ) * cLightRange;
+            double vfrac = vexact - floor( vexact );
+            bool vtie = fabs( vfrac - 0.5 ) < cTieTolerance;
+
+            if ( abs( vfast - vref ) > 1 || !vtie ){
+                vnumFail++;
+                printf( "raw %d gain %d: lut %d ref %d exact %.6f\n", vraw, vgain, vfast, vref, vexact );
+            }
+        }
+    }
+
+    printf( "%d pairs, %ld differ at rounding ties, %ld failed\n",
+            cLuxLutRawSize * cLuxLutGainSize, vnumDiff - vnumFail, vnumFail );
+    return vnumFail > 0 ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host check: PlokResonatorFixed vs PlokResonatorFloat
+//
+// build:  g++ -O2 -I include -o plokcheck tools/PlokFixedCheck.cpp
+// usage:  plokcheck
+//
+// random ploks over the parameter ranges used by LarvaString
+// (freq, Q, gain, burst length), same coefficients & noise for both.
+// Per plok: max abs difference over its 50ms life vs the float peak.
+// Exit code 1 if any plok is above cMaxErrorDb.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <stdio.h>
+#include <math.h>
+#include "PlokResonator.hpp"
+#include "RandStream.hpp"
+#include "FloatEnv.hpp"
+
+static const float cSampleRate = 32768.f;
+static const int cLifeSamples = 1638; // 50ms
+static const int cNumPloks = 20000;
+// the 16 bit coefficients alone give -63.7dB (slight pole detune)
+static const double cMaxErrorDb = -60.0;
+
+int main(){
+
+    FloatEnvFlushToZero();
+
+    RandStream vrand;
+    vrand.Seed( 1 );
+
+    double vworstDb = -200.0;
+    double vsumDb = 0.0;
+
+    for ( int n = 0; n < cNumPloks; ++n ){
+
+        float vfc = 100.f * powf( 60.f, vrand.Uniform() );  // 100Hz..6kHz
+        float vq = 10.f + 50.f * vrand.Uniform();
+        float vgain = 2.f + 17.f * vrand.Uniform(); // up to cPulseGainL * cPulseMasterGainMax
+        int vdur = 10 + vrand.Range( 20 );
+
+        // as Plok::UpdateBiquad()
+        float vw = 2.f * (float)M_PI * vfc / cSampleRate;
+        float vr = expf( -vw / vq );
+        float va2 = -vr * vr;
+        float va1 = 2.f * vr * cosf( vw );
+        float vb0 = vr * vgain * ( 1.f - vr );
+
+        PlokResonatorFloat vref;
+        PlokResonatorFixed vfix;
+        vref.SetCoefs( vb0, va1, va2 );
+        vfix.SetCoefs( vb0, va1, va2 );
+
+        double vpeak = 0.0;
+        double verr = 0.0;
+        for ( int k = 0; k < cLifeSamples; ++k ){
+            float vy, vyfix;
+            if ( k < vdur + 2 ){
+                float vin = k < vdur ? vrand.Bipolar() * 1.5f : 0.f;
+                vy = vref.Excite( vin );
+                vyfix = PlokResonatorFixed::ToFloat( vfix.Excite( vin ) );
+            }
+            else {
+                vy = vref.Ring();
+                vyfix = PlokResonatorFixed::ToFloat( vfix.Ring() );
+            }
+            vpeak = fabs( vy ) > vpeak ? fabs( vy ) : vpeak;
+            verr = fabs( vy - vyfix ) > verr ? fabs( vy - vyfix ) : verr;
+        }
+
+        double vdb = 20.0 * log10( ( verr + 1e-12 ) / ( vpeak + 1e-12 ) );
+        vsumDb += vdb;
+        if ( vdb > vworstDb ){
+            vworstDb = vdb;
+            printf( "worst so far: fc %.1f q %.1f gain %.1f dur %d: peak %.4f err %.6f (%.1f dB)\n",
+                    vfc, vq, vgain, vdur, vpeak, verr, vdb );
+        }
+    }
+
+    printf( "%d ploks, error vs peak: mean %.1f dB, worst %.1f dB (limit %.1f dB)\n",
+            cNumPloks, vsumDb / cNumPloks, vworstDb, cMaxErrorDb );
+    return vworstDb > cMaxErrorDb ? 1 : 0;
+}
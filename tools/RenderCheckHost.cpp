@@ -0,0 +1,60 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host render check: RunRenderCheck() off the board
+//
+// build:  g++ -O2 -DARDUINO=10805 -DESP32 -DRENDER_CHECK_HOST 
+//             -I tools/host -I include -I lib/Mozzi -o rendercheck 
+//             tools/RenderCheckHost.cpp src/RenderCheck.cpp src/LarvaSynth2.cpp 
+//             src/LarvaChord.cpp src/LarvaString.cpp src/Plok.cpp lib/Mozzi/mozzi_utils.cpp
+// usage:  rendercheck
+//
+// renders the canonical traces with the default LarvaDefs.hpp switches
+// and compares against the host hashes in GoldenHashes.hpp. Prints the
+// tables to paste there when recapturing. Exit code 1 on divergence.
+// Captured on x86-64 without -march, so no fused multiply-add.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <chrono>
+#include "Arduino.h"
+#include "RenderCheck.hpp"
+
+#ifndef RENDER_CHECK_HOST
+#error build with -DRENDER_CHECK_HOST, see above
+#endif
+
+HostSerial Serial;
+
+static const std::chrono::steady_clock::time_point cStart = std::chrono::steady_clock::now();
+
+unsigned long millis(){
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>( 
+                std::chrono::steady_clock::now() - cStart ).count();
+}
+
+unsigned long micros(){
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>( 
+                std::chrono::steady_clock::now() - cStart ).count();
+}
+
+long map( long x, long in_min, long in_max, long out_min, long out_max ){
+    return ( x - in_min ) * ( out_max - out_min ) / ( in_max - in_min ) + out_min;
+}
+
+// mozzi_rand: LarvaSynth2::Init() only seeds from noise with seed 0,
+// the render check uses cRenderCheckSeed
+void randSeed(){}
+unsigned long xorshift96(){ return 0; }
+
+int main(){
+    int vnumfailed = RunRenderCheck();
+    printf( "%s\n", vnumfailed == 0 ? "render check ok" : "render check FAILED" );
+    return vnumfailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host decoder for the binary telemetry stream (build with TELEMETRY)
+//
+// build:  g++ -O2 -I include -o telemetry_decode tools/TelemetryDecode.cpp
+// usage:  stty -F /dev/ttyUSB0 115200 raw && telemetry_decode < /dev/ttyUSB0
+//         telemetry_decode capture.bin > capture.csv
+//
+// prints one CSV line per valid frame, lost frames are reported on stderr
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include <stdio.h>
+#include "TelemetryRecord.hpp"
+
+int main( int argc, char** argv )
+{
+    FILE* vin = stdin;
+    if ( argc > 1 ){
+        vin = fopen( argv[1], "rb" );
+        if ( vin == NULL ){
+            fprintf( stderr, "cannot open %s\n", argv[1] );
+            return 1;
+        }
+    }
+
+    printf( "time_ms,lux_raw,lux_scaled,gain,saturated,calibrating,delta_scaler,"
+            "triggers_avg,pulse_gain,pulse_res,chords,strings,partials,ploks,cpu_load,shed_level,"
+            "clips,peak\n" );
+
+    TelemetryParser vparser;
+    TelemetryRecord vrec;
+    bool vfirst = true;
+    uint8_t vnextseq = 0;
+    unsigned long vlost = 0;
+
+    int c;
+    while ( ( c = fgetc( vin ) ) != EOF ){
+
+        if ( !vparser.Push( (uint8_t)c, vrec ) ){
+            continue;
+        }
+
+        if ( !vfirst && vrec.seq != vnextseq ){
+            vlost += (uint8_t)( vrec.seq - vnextseq );
+        }
+        vfirst = false;
+        vnextseq = (uint8_t)( vrec.seq + 1 );
+
+        printf( "%lu,%u,%u,%u,%d,%d,%.3f,%u,%.3f,%.2f,%u,%u,%u,%u,%.3f,%u,%u,%.3f\n",
+                (unsigned long)vrec.timeMs, vrec.luxRaw, vrec.luxScaled, vrec.gain,
+                ( vrec.flags & kTelemSaturated ) ? 1 : 0,
+                ( vrec.flags & kTelemCalibrating ) ? 1 : 0,
+                vrec.deltaScaler * 0.001f, vrec.triggersAvg,
+                vrec.pulseGain * 0.001f, vrec.pulseRes * 0.01f,
+                vrec.numChords, vrec.numStrings, vrec.numPartials, vrec.numPloks,
+                vrec.cpuLoad * 0.001f, vrec.shedLevel, 
+                vrec.clips, vrec.peak * 0.001f );
+        fflush( stdout );
+    }
+
+    fprintf( stderr, "lost frames: %lu, bad frames: %lu\n", 
+             vlost, (unsigned long)vparser.NumBadFrames() );
+
+    if ( vin != stdin ){
+        fclose( vin );
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// KOMOREBI KIT, 2021 
+//
+// Created by Matteo Marangoni & Dieter Vandoren 
+// Programming by Riccardo Marogna
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Host shim: the part of the ESP32 Arduino core the synth uses
+//
+// for the host tools that build the synth sources (RenderCheckHost.cpp),
+// not for the firmware. Definitions are in the tool.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <limits.h>
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x02
+
+#define PI 3.1415926535897932384626433832795
+#define PROGMEM
+#define IRAM_ATTR
+#define F_CPU 240000000L
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_float(addr) (*(const float*)(addr))
+
+using std::min;
+using std::max;
+
+void pinMode( uint8_t pin, uint8_t mode );
+void digitalWrite( uint8_t pin, uint8_t val );
+unsigned long millis();
+unsigned long micros();
+long map( long x, long in_min, long in_max, long out_min, long out_max );
+
+// Serial --> stdout
+struct HostSerial
+{
+    void begin( unsigned long ){}
+    void print( const char* acStr ){ fputs( acStr, stdout ); }
+    void print( const int acValue ){ printf( "%d", acValue ); }
+    void print( const long acValue ){ printf( "%ld", acValue ); }
+    void print( const unsigned long acValue ){ printf( "%lu", acValue ); }
+    void print( const double acValue, const int acDigits = 2 ){ printf( "%.*f", acDigits, acValue ); }
+    void println(){ fputs( "\n", stdout ); }
+    template <typename T> void println( const T acValue ){ print( acValue ); println(); }
+};
+
+extern HostSerial Serial;